@@ -20,9 +20,23 @@
  *
  *-----------------------------------------------------------------*/
 
+/*-----------------------------------------------------------------
+ *   IMPLEMENTATION NOTES
+ * The nodes are kept in a vector, and the edges of each node in
+ * a vector too, so a node is reached in constant time and an
+ * edge is appended in amortized constant time. The edges are
+ * appended in the order of insertion, and the list of a node is
+ * sorted (by destination) only when it is read or edited after
+ * an edge has been inserted out of order; a repeated edge is
+ * reported as an error at that time, or at once if it repeats
+ * the last edge inserted.
+ *-----------------------------------------------------------------*/
+
 #ifndef ARGEDIT_H
 #define ARGEDIT_H
 
+#include <vector>
+
 #include "argraph.h"
 
 
@@ -58,24 +72,20 @@ class ARGEdit: public ARGLoader
       int count;
 
       struct eNode
-        { node_id from;
-          node_id to;
-          int pos;
+        { node_id to;
           void *attr;
-          eNode *next;
+          bool operator<(const eNode &e) const { return to<e.to; }
         };
 
       struct nNode 
-        { node_id id;
-          int count;
-          void *attr;
-          nNode *next;
-          eNode *edges;
+        { void *attr;
+          bool sorted;       // false if edges must be sorted
+          std::vector<eNode> edges;
         };
 
-      nNode *nodes;
-      nNode *lastNode;
-      eNode *lastEdge;
+      std::vector<nNode> nodes;
+
+      nNode &sortedNode(node_id id);
 
       virtual void destroyNodeAttr(void *) {};
       virtual void destroyEdgeAttr(void *) {};
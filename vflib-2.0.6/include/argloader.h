@@ -3,7 +3,7 @@
  * Interface of argloader.cc
  * Definition of a simple ARG loader based on iostream using text files,
  * and of a binary file unattributed Graph loader.
- * See: argraph.h
+ * See: argraph.h zstream.h
  *
  * Author: P. Foggia
  *-----------------------------------------------------------------*/
@@ -40,6 +40,19 @@
 
      # Edges coming out of node 2
      0
+ * StreamARGLoader reads the file in large blocks, and parses the
+ * ids and the counts directly from the block. The attributes are
+ * read by AttrParser<T>::Parse, which for the integer and floating
+ * point types parses the text directly, and for the other types
+ * uses the operator >> of T on the rest of the line; AttrParser can
+ * be specialized for other types (see below). The errors are
+ * reported with the number of the line.
+ * Since the input is read in blocks, at the end the loader moves
+ * the stream back after the last line used, which is possible
+ * only if the stream supports seekg (e.g. a file); otherwise the
+ * text following the graph is lost.
+ * Both the loaders can read files compressed with gzip or zstd
+ * through a DecompressStream (see zstream.h).
   *-----------------------------------------------------------------*/
 
 
@@ -59,13 +72,19 @@
  *     02 00     Target of the second edge of node 1 (edge 1 -> 2)
  *     01 00     Number of edges out of node 2 (1)
  *     00 00     Target of the first (and only) edge of node 2 (edge 2 -> 0)
+ * The constructor and write() have a parameter word_size, which can
+ * be 4 to use 32-bit words instead (for graphs with more than
+ * 65535 nodes, or nodes with more than 65535 edges; the graph
+ * must also fit in node_id, see VF_NODE_ID_32 in argraph.h).
  ---------------------------------------------------------------------------*/
 
 #ifndef ARGLOADER_H
 #define ARGLOADER_H
 
 #include <iostream>
-#include <strstream>
+#include <sstream>
+#include <limits>
+#include <vector>
 #include <ctype.h>
 
 
@@ -73,7 +92,7 @@
 // if the following line cause errors, your compiler
 // does not recognize C++ namespaces. Just comment it out.
 // You will probably also have to replace <iostream> with <iostream.h>
-// and <strstream> with <strstream.h> (or maybe <strstrea.h>) in the
+// and <sstream> with <strstream.h> (or maybe <strstrea.h>) in the
 // above #include directives.
 //
 using namespace std;
@@ -83,6 +102,128 @@ using namespace std;
 #include "argedit.h"
 #include "allocpool.h"
 
+
+/*----------------------------------------------------------
+ * class ARGLineReader
+ * Reads the lines of a text file which are not blank or
+ * comments, from a large buffer
+ ---------------------------------------------------------*/
+class ARGLineReader
+  { public:
+      ARGLineReader(istream &in);
+      char *NextLine();
+      int LineNumber() { return line_no; }
+      void Finish();
+
+    private:
+      enum { BLOCK_SIZE=65536 };
+      istream &in;
+      std::vector<char> buf;  // Holds the bytes buf[pos] ... buf[len-1]
+      size_t pos, len;        // not used yet
+      int line_no;
+      bool eof;
+
+      char *readLine();
+  };
+
+
+/*----------------------------------------------------------
+ * Parsing of numbers: the functions skip the leading spaces,
+ * and advance *ptext after the number if one is found
+ ---------------------------------------------------------*/
+bool parse_integer(const char **ptext, long long *v);
+bool parse_unsigned(const char **ptext, unsigned long long *v);
+bool parse_real(const char **ptext, double *v);
+
+
+/*----------------------------------------------------------
+ * class AttrParser
+ * Reads an attribute of type T from the text following the
+ * ids of a node or edge, returning false if the text is not
+ * valid. The generic version uses the operator >> of T; it can
+ * be specialized, e.g.:
+ *
+ *     template <> class AttrParser<Point>
+ *       { public:
+ *           bool Parse(const char *text, Point *p)
+ *               { double x, y;
+ *                 if (!parse_real(&text, &x) || !parse_real(&text, &y))
+ *                   return false;
+ *                 p->x=x; p->y=y;
+ *                 return true;
+ *               }
+ *       };
+ ---------------------------------------------------------*/
+template <class T>
+class AttrParser
+  { private:
+      istringstream is;
+    public:
+      bool Parse(const char *text, T *attr)
+          { is.clear();
+            is.str(text);
+            is >> *attr;
+            return true;  // As in the previous versions, errors
+                          // of operator >> are not detected
+          }
+  };
+
+template <class T>
+class IntegerAttrParser
+  { public:
+      bool Parse(const char *text, T *attr)
+          { long long v;
+            if (!parse_integer(&text, &v) ||
+                v<(long long)std::numeric_limits<T>::min() ||
+                v>(long long)std::numeric_limits<T>::max())
+              return false;
+            *attr=(T)v;
+            return true;
+          }
+  };
+
+template <class T>
+class UnsignedAttrParser
+  { public:
+      bool Parse(const char *text, T *attr)
+          { unsigned long long v;
+            if (!parse_unsigned(&text, &v) ||
+                v>(unsigned long long)std::numeric_limits<T>::max())
+              return false;
+            *attr=(T)v;
+            return true;
+          }
+  };
+
+template <class T>
+class RealAttrParser
+  { public:
+      bool Parse(const char *text, T *attr)
+          { double v;
+            if (!parse_real(&text, &v))
+              return false;
+            *attr=(T)v;
+            return true;
+          }
+  };
+
+template <> class AttrParser<short>: public IntegerAttrParser<short> {};
+template <> class AttrParser<int>: public IntegerAttrParser<int> {};
+template <> class AttrParser<long>: public IntegerAttrParser<long> {};
+template <> class AttrParser<long long>:
+    public IntegerAttrParser<long long> {};
+template <> class AttrParser<unsigned short>:
+    public UnsignedAttrParser<unsigned short> {};
+template <> class AttrParser<unsigned int>:
+    public UnsignedAttrParser<unsigned int> {};
+template <> class AttrParser<unsigned long>:
+    public UnsignedAttrParser<unsigned long> {};
+template <> class AttrParser<unsigned long long>:
+    public UnsignedAttrParser<unsigned long long> {};
+template <> class AttrParser<float>: public RealAttrParser<float> {};
+template <> class AttrParser<double>: public RealAttrParser<double> {};
+
+
 template <class Node, class Edge>
 class StreamARGLoader: public ARGEdit
   { 
@@ -98,23 +239,38 @@ class StreamARGLoader: public ARGEdit
 
     private:
 
-      enum { MAX_LINE=512 };
-      void readLine(istream &in, char *line);
-      int  readCount(istream &in);
-      void readNode(NodeAllocator *alloc, istream &in);
-      void readEdge(EdgeAllocator *alloc, istream &in);
+      int  readCount(ARGLineReader &rd);
+      void readNode(NodeAllocator *alloc, AttrParser<Node> &parser,
+                    ARGLineReader &rd);
+      void readEdge(EdgeAllocator *alloc, AttrParser<Edge> &parser,
+                    ARGLineReader &rd);
   };
 
 
-class BinaryGraphLoader: public ARGEdit
+class BinaryGraphLoader: public ARGLoader
   { public:
-      BinaryGraphLoader(istream &in);
-      static void write(ostream &out, Graph &g);
-      static void write(ostream &out, ARGLoader &g);
+      BinaryGraphLoader(istream &in, int word_size=2);
+      static void write(ostream &out, Graph &g, int word_size=2);
+      static void write(ostream &out, ARGLoader &g, int word_size=2);
+
+      int NodeCount() { return out_start.size()-1; }
+      void *GetNodeAttr(node_id node) { return NULL; }
+      int OutEdgeCount(node_id node)
+          { return out_start[node+1]-out_start[node]; }
+      node_id GetOutEdge(node_id node, int i, void **pattr)
+          { if (pattr!=NULL)
+              *pattr=NULL;
+            return out_node[out_start[node]+i];
+          }
 
     private:
-      static unsigned readWord(istream &in);
-      static void writeWord(ostream &out, unsigned w);
+      std::vector<int> out_start;    // The edges of node i are
+      std::vector<node_id> out_node; // out_node[out_start[i]] ...
+
+      static void readWords(istream &in, int word_size,
+                            std::vector<unsigned char> &buf,
+                            std::vector<unsigned> &words, unsigned count);
+      static void writeWord(ostream &out, unsigned w, int word_size);
   };
 
 
@@ -131,42 +287,28 @@ StreamARGLoader(Allocator<Node> *nalloc,
                 Allocator<Edge> *ealloc, 
                 istream &in)
   { 
-    int cnt=readCount(in);
+    ARGLineReader rd(in);
+    int cnt=readCount(rd);
     if (cnt<=0)
       { cnt=0;
+        rd.Finish();
         return;
       }
 
+    AttrParser<Node> nparser;
+    AttrParser<Edge> eparser;
     int i;
     for(i=0; i<cnt; i++)
-      { readNode(nalloc, in);
+      { readNode(nalloc, nparser, rd);
       }
 
     for(i=0; i<cnt; i++)
       { int ecount, j;
-        ecount=readCount(in);
+        ecount=readCount(rd);
         for(j=0; j<ecount; j++)
-          readEdge(ealloc, in);
+          readEdge(ealloc, eparser, rd);
       }
-        
-  }
-
-/*------------------------------------------------------
- * Reads a line from the input stream
- ----------------------------------------------------*/
-template <class Node, class Edge>
-void StreamARGLoader<Node, Edge>::
-readLine(istream &in, char *line)
-  { 
-    char *p;
-    do {
-      *line='\0';
-      if (!in.good())
-        error("End of file or reading error");
-      in.getline(line, MAX_LINE);
-      for(p=line; isspace(*p); p++)
-        ;
-    } while (*p=='\0' || *p=='#');
+    rd.Finish();
   }
 
 /*------------------------------------------------------
@@ -174,15 +316,13 @@ readLine(istream &in, char *line)
  ----------------------------------------------------*/
 template <class Node, class Edge>
 int StreamARGLoader<Node, Edge>::
-readCount(istream &in)
-  { char line[MAX_LINE+1];
-    readLine(in, line);
-    
-    int i;
-    istrstream is(line);
-    is>>i;
-
-    return i;
+readCount(ARGLineReader &rd)
+  { const char *p=rd.NextLine();
+    long long i;
+    if (!parse_integer(&p, &i) || i>std::numeric_limits<int>::max())
+      error("File format error at line %d: bad count",
+            rd.LineNumber());
+    return (int)i;
   }
 
 /*------------------------------------------------------
@@ -190,18 +330,19 @@ readCount(istream &in)
  ----------------------------------------------------*/
 template <class Node, class Edge>
 void StreamARGLoader<Node, Edge>::
-readNode(Allocator<Node> *alloc, istream &in)
-  { char line[MAX_LINE+1];
-    readLine(in, line);
-    istrstream is(line);
-    
-    Node *nattr=alloc->Allocate();
-    node_id id;
+readNode(Allocator<Node> *alloc, AttrParser<Node> &parser,
+         ARGLineReader &rd)
+  { const char *p=rd.NextLine();
+    unsigned long long id;
 
-    is >> id >> *nattr;
+    if (!parse_unsigned(&p, &id) || id != (unsigned long long)NodeCount())
+      error("File format error at line %d: bad node id",
+            rd.LineNumber());
 
-    if (id != NodeCount())
-      error("File format error\n  Line: %s", line);
+    Node *nattr=alloc->Allocate();
+    if (nattr!=NULL && !parser.Parse(p, nattr))
+      error("File format error at line %d: bad node attribute",
+            rd.LineNumber());
 
     InsertNode(nattr);
   }
@@ -211,15 +352,21 @@ readNode(Allocator<Node> *alloc, istream &in)
  ----------------------------------------------------*/
 template <class Node, class Edge>
 void StreamARGLoader<Node, Edge>::
-readEdge(Allocator<Edge> *alloc, istream &in)
-  { char line[MAX_LINE+1];
-    readLine(in, line);
-    istrstream is(line);
-    
-    Edge *eattr=alloc->Allocate();
-    node_id id1, id2;
+readEdge(Allocator<Edge> *alloc, AttrParser<Edge> &parser,
+         ARGLineReader &rd)
+  { const char *p=rd.NextLine();
+    unsigned long long id1, id2;
+
+    if (!parse_unsigned(&p, &id1) || !parse_unsigned(&p, &id2) ||
+        id1 >= (unsigned long long)NodeCount() ||
+        id2 >= (unsigned long long)NodeCount())
+      error("File format error at line %d: bad edge",
+            rd.LineNumber());
 
-    is >> id1 >> id2 >> *eattr;
+    Edge *eattr=alloc->Allocate();
+    if (eattr!=NULL && !parser.Parse(p, eattr))
+      error("File format error at line %d: bad edge attribute",
+            rd.LineNumber());
 
     InsertEdge(id1, id2, eattr);
   }
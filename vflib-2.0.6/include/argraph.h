@@ -42,13 +42,32 @@
 
 /*--------------------------------------------------------------------
  *   MORE IMPLEMENTATION DETAILS
- * Edges and edge attributes (pointers) are stored into sorted 
- * vectors associated to each node, and are looked for
- * using binary search. 
+ * Edges and edge attributes (pointers) are stored in compressed
+ * sparse row form: for each direction there is a single vector
+ * of the adjacent nodes, holding the sorted list of each node
+ * after the one of the previous node, and a vector of n+1
+ * offsets where the lists begin. The edges are looked for in
+ * an open addressing hash table of their positions for the long
+ * lists (at least HASH_MIN_DEGREE edges), and with binary
+ * search in the others. FindEdge returns the position (slot)
+ * of an edge in the 'out' vectors, from which its attribute is
+ * read with GetSlotAttr, so testing an edge and reading its
+ * attribute costs a single lookup; the position of the same
+ * edge in the 'in' vectors is kept for each slot (see
+ * GetReverseSlot).
+ * A derived class can also build the graph over vectors of the
+ * edges it owns, e.g. mapped from a file (see csrgraph.h).
+ * The vectors of the node
+ * and of the edge attributes are allocated only if some
+ * attribute is not NULL, so a graph without attributes (e.g.
+ * one read by a BinaryGraphLoader) has only the vectors of the
+ * node ids.
  * 
- * Nodes are identified using the type node_id, which is currently
- * unsigned short; the special value NULL_NODE is used as null
- * value for this type.
+ * Nodes are identified using the type node_id, which is
+ * unsigned short, or unsigned int if the macro VF_NODE_ID_32 is
+ * defined; the special value NULL_NODE is used as null
+ * value for this type, so a graph can have at most NULL_NODE
+ * nodes. The degrees and the edge offsets are ints.
  *
  * Bound checks are performed using the assert macro. They can be
  * disabled by ensuring the macro NDEBUG is defined during 
@@ -57,6 +76,11 @@
  * NOTE: Differently from the previous versions  of this library 
  * (before version 2.0), there is no more an adjacency matrix to 
  * check for the existence of a node.
+ *
+ * An undirected graph is represented by pairs of opposite edges;
+ * the constructor detects when each edge has its reverse, so
+ * that the matching algorithms can visit a single list of
+ * neighbours (see IsUndirected).
  --------------------------------------------------------------------*/
 
 #ifndef ARGRAPH_H
@@ -82,8 +106,19 @@ const true=1
 typedef unsigned char byte;
 #endif
 
+/*----------------------------------------------------------------
+ * Node ids are 16 bit, which keeps the vectors of the graphs and
+ * of the states small; defining VF_NODE_ID_32 (for the library
+ * and for the programs using it) makes them 32 bit, for graphs
+ * with more than 65534 nodes.
+ ---------------------------------------------------------------*/
+#ifdef VF_NODE_ID_32
+typedef unsigned int node_id;
+const node_id NULL_NODE=0xFFFFFFFF;
+#else
 typedef unsigned short node_id;
 const node_id NULL_NODE=0xFFFF;
+#endif
 
 /*----------------------------------------------------------------
  * Abstract class ARGLoader. Allows to construct an ARGraph
@@ -139,25 +174,43 @@ class ARGraph_impl
       typedef bool (*node_compat_fn)(void *, void *);
       typedef bool (*edge_compat_fn)(void *, void *);
 
+      typedef void *edge_attr_type; // Type of the attributes returned
+                                    // by GetOutEdge/GetInEdge
+
 
+    protected:
+      int n;              /* number of nodes  */
+      void* *attr;        /* node attributes, or NULL  */
+      int *in_start;      /* 'in' edges of node i are at in_start[i] ...
+                             in_start[i+1]-1 (n+1 elements) */
+      node_id *in_node;   /* nodes connected by 'in' edges */
+      void* *in_attr;     /* Edge attributes for 'in' edges, or NULL */
+      int *out_start;     /* 'out' edges of node i are at out_start[i] ...
+                             out_start[i+1]-1 (n+1 elements) */
+      node_id *out_node;  /* nodes connected by 'out' edges */
+      void* *out_attr;    /* Edge attributes for 'out' edges, or NULL */
+      int *out_rev;       /* position in the 'in' vectors of each
+                             'out' edge */
+      bool shared_edges;  /* true if the vectors of the edges belong
+                             to someone else (e.g. a mapped file) */
 
     private:
-      typedef short count_type;
+      enum { HASH_MIN_DEGREE=64 };   /* lists with a hash table */
+      int *hash_start;    /* hash table of the 'out' edges of node i at
+                             hash_slot[hash_start[i]] ...
+                             hash_slot[hash_start[i+1]-1], empty if
+                             its degree is below HASH_MIN_DEGREE;
+                             NULL if no node has one */
+      int *hash_slot;     /* positions in out_node, or -1 */
 
-      int n;              /* number of nodes  */
-      void* *attr;        /* node attributes  */
-      count_type  *in_count;  /* number of 'in' edges for each node */
-      node_id **in;       /* nodes connected by 'in' edges to each node */
-      void* **in_attr;    /* Edge attributes for 'in' edges */
-      count_type  *out_count; /* number of 'out edges for each node */
-      node_id **out;      /* nodes connected by 'out' edges to each node */
-      void* **out_attr;   /* Edge attributes for 'out' edges */
+      void buildHashTables();
 
       AttrDestroyer *node_destroyer;  // Used to clean up node attrs
       AttrDestroyer *edge_destroyer;  // Used to clean up edge attrs
       AttrComparator *node_comparator; // Used to test node attr. compat.
       AttrComparator *edge_comparator; // Used to test edge attr. compat.
 
+      bool undirected;    /* true if each edge has its reverse */
 
 
 
@@ -172,12 +225,19 @@ class ARGraph_impl
       void SetNodeCompat(node_compat_fn); // For older versions
       void SetEdgeCompat(edge_compat_fn); // For older versions
 
+    protected:
+      ARGraph_impl(int n, int *out_start, node_id *out_node,
+                   int *in_start, node_id *in_node, int *out_rev,
+                   bool undirected);
+
     public:
       ARGraph_impl(ARGLoader *loader);
       virtual ~ARGraph_impl();
 
 
       int NodeCount();
+      bool IsUndirected() { return undirected; }
+      bool HasEdgeAttrs() { return out_attr!=NULL; }
 
       void *GetNodeAttr(node_id i);
       void SetNodeAttr(node_id i, void *attr, bool destroyOld=false);
@@ -188,6 +248,10 @@ class ARGraph_impl
       void SetEdgeAttr(node_id n1, node_id n2, void *attr, 
                        bool destroyOld=false);
 
+      int FindEdge(node_id n1, node_id n2);
+      void *GetSlotAttr(int slot);
+      int GetReverseSlot(int slot);
+
       int InEdgeCount(node_id node);
       int OutEdgeCount(node_id node); 
       int EdgeCount(node_id node); 
@@ -261,6 +325,8 @@ class ARGraph: public ARGraph_impl
 
       Edge *GetEdgeAttr(node_id n1, node_id n2)
                  { return (Edge*)ARGraph_impl::GetEdgeAttr(n1,n2); }
+      Edge *GetSlotAttr(int slot)
+                 { return (Edge*)ARGraph_impl::GetSlotAttr(slot); }
 
       node_id GetInEdge(node_id node, int i, Edge **pattr)
                  { return ARGraph_impl::GetInEdge(node, i, (void**)pattr); }
@@ -327,8 +393,8 @@ inline int ARGraph_impl::NodeCount()
  * Attribute of a node
  ---------------------------------------------*/
 inline void * ARGraph_impl::GetNodeAttr(node_id i) 
-  { assert(i<n);
-    return attr[i];
+  { assert(i<(node_id)n);
+    return attr? attr[i]: NULL;
   }
 
 /*----------------------------------------------
@@ -350,12 +416,32 @@ inline void* ARGraph_impl::GetEdgeAttr(node_id n1, node_id n2)
     }
 
 
+/*----------------------------------------------
+ * Attribute of the edge at a position returned
+ * by FindEdge
+ ---------------------------------------------*/
+inline void* ARGraph_impl::GetSlotAttr(int slot)
+    { assert(slot>=0 && slot<out_start[n]);
+      return out_attr? out_attr[slot]: NULL;
+    }
+
+/*----------------------------------------------
+ * Index among the 'in' edges of n2 of the edge
+ * (n1, n2) at a position returned by FindEdge,
+ * i.e. the i for which GetInEdge(n2, i)==n1
+ ---------------------------------------------*/
+inline int ARGraph_impl::GetReverseSlot(int slot)
+    { assert(slot>=0 && slot<out_start[n]);
+      return out_rev[slot]-in_start[out_node[slot]];
+    }
+
+
 /*------------------------------------------------
  * Number of edges going into a node
  ------------------------------------------------*/
 inline int ARGraph_impl::InEdgeCount(node_id node) 
-  { assert(node<n); 
-    return in_count[node]; 
+  { assert(node<(node_id)n); 
+    return in_start[node+1]-in_start[node]; 
   }
 
 
@@ -363,8 +449,8 @@ inline int ARGraph_impl::InEdgeCount(node_id node)
  * Number of edges departing from a node
  ------------------------------------------------*/
 inline int ARGraph_impl::OutEdgeCount(node_id node) 
-  { assert(node<n); 
-    return out_count[node]; 
+  { assert(node<(node_id)n); 
+    return out_start[node+1]-out_start[node]; 
   }
 
 
@@ -372,17 +458,18 @@ inline int ARGraph_impl::OutEdgeCount(node_id node)
  * Number of edges touching a node
  ------------------------------------------------*/
 inline int ARGraph_impl::EdgeCount(node_id node) 
-  { assert(node<n); 
-    return in_count[node]+out_count[node]; 
+  { assert(node<(node_id)n); 
+    return in_start[node+1]-in_start[node]+
+           out_start[node+1]-out_start[node]; 
   }
 
 /*------------------------------------------------
  * Gets the other end of an edge entering a node
  -----------------------------------------------*/
 inline node_id ARGraph_impl::GetInEdge(node_id node, int i)
-  { assert(node<n);
-    assert(i<in_count[node]);
-    return in[node][i];
+  { assert(node<(node_id)n);
+    assert(i<InEdgeCount(node));
+    return in_node[in_start[node]+i];
   }
 
 /*------------------------------------------------
@@ -391,10 +478,11 @@ inline node_id ARGraph_impl::GetInEdge(node_id node, int i)
  -----------------------------------------------*/
 inline node_id ARGraph_impl::GetInEdge(node_id node, int i, 
                                        void **pattr)
-  { assert(node<n);
-    assert(i<in_count[node]);
-    *pattr = in_attr[node][i];
-    return in[node][i];
+  { assert(node<(node_id)n);
+    assert(i<InEdgeCount(node));
+    int k=in_start[node]+i;
+    *pattr = in_attr? in_attr[k]: NULL;
+    return in_node[k];
   }
 
 
@@ -402,9 +490,9 @@ inline node_id ARGraph_impl::GetInEdge(node_id node, int i,
  * Gets the other end of an edge leaving a node
  -----------------------------------------------*/
 inline node_id ARGraph_impl::GetOutEdge(node_id node, int i)
-  { assert(node<n);
-    assert(i<out_count[node]);
-    return out[node][i];
+  { assert(node<(node_id)n);
+    assert(i<OutEdgeCount(node));
+    return out_node[out_start[node]+i];
   }
 
 /*------------------------------------------------
@@ -413,10 +501,11 @@ inline node_id ARGraph_impl::GetOutEdge(node_id node, int i)
  -----------------------------------------------*/
 inline node_id ARGraph_impl::GetOutEdge(node_id node, int i, 
                                         void **pattr)
-  { assert(node<n);
-    assert(i<out_count[node]);
-    *pattr = out_attr[node][i];
-    return out[node][i];
+  { assert(node<(node_id)n);
+    assert(i<OutEdgeCount(node));
+    int k=out_start[node]+i;
+    *pattr = out_attr? out_attr[k]: NULL;
+    return out_node[k];
   }
 
 /*-----------------------------------------------------------
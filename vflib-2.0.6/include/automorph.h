@@ -0,0 +1,104 @@
+/*------------------------------------------------------------------
+ * automorph.h
+ * Header of automorph.cc
+ * Definition of a class representing the automorphism group of
+ * a graph, and of the functions that find all the isomorphisms
+ * between two graphs as one isomorphism plus that group.
+ * See: match.h state.h
+ *-----------------------------------------------------------------*/
+
+
+/*-----------------------------------------------------------------
+ *   DESCRIPTION
+ * If phi is an isomorphism from g1 to g2, the set of all the
+ * isomorphisms from g1 to g2 is { phi o a : a in Aut(g1) }.
+ * match_group() finds phi and a set of generators of Aut(g1)
+ * with a single search on the SSR of g1 and g2: whenever a
+ * second isomorphism psi is found, phi^-1 o psi is an
+ * automorphism of g1. The nodes of g1 are kept partitioned
+ * into the orbits of the generators found so far (with a
+ * union-find structure), and the candidate pairs equivalent
+ * to an already explored one are skipped, so the number of
+ * explored branches is roughly proportional to the number of
+ * generators, instead of the order of the group.
+ *
+ * The generators are found along the path to phi, starting
+ * from the deepest level: at level d, the generators fix the
+ * first d nodes of that path (the "base"), so the group order
+ * is the product of the orbit lengths of the base nodes, and
+ * the whole set of isomorphisms can be visited without any
+ * further search (see AutomorphismGroup::Visit).
+ *
+ * NOTE: the initial state must be a state for graph isomorphism
+ * (e.g. VF2State, MyVF2State, SDState), whose NextPair proposes
+ * pairs with the same node of g1 in each state, as all the
+ * states of the library do. For the other kinds of matching
+ * the matches are not a coset of Aut(g1).
+ *-----------------------------------------------------------------*/
+
+
+#ifndef AUTOMORPH_H
+#define AUTOMORPH_H
+
+#include "argraph.h"
+#include "state.h"
+#include "match.h"
+
+
+/*----------------------------------------------------------
+ * class AutomorphismGroup
+ * A set of generators of the automorphism group of g1,
+ * together with the orbits of its nodes.
+ * Each generator is a vector gen, mapping node i to gen[i].
+ ---------------------------------------------------------*/
+class AutomorphismGroup
+  { private:
+      int n;
+      node_id *base;     // The nodes of g1 along the path to phi
+      int base_len;
+      int *orbit_len;    // Length of the orbit of base[d] under
+                         // the stabilizer of base[0]...base[d-1]
+      node_id **gen;
+      int *gen_level;    // Level at which each generator was found
+      int gen_count, gen_size;
+
+      node_id *parent;   // Union-find forest of the orbits
+      int *orbit_size;
+      int *fail_level;   // Level at which an orbit has no match
+      node_id *phi_inv;  // Used only during the search
+      node_id *c1, *c2;
+
+      bool searchFirst(State *s, int level, node_id phi[]);
+      void exploreLevel(State *s, int level, node_id n1, node_id n2);
+      void addGenerator(node_id *perm, int level);
+      void unite(node_id a, node_id b, int level);
+
+      // Not implemented: the vectors are owned by the group
+      AutomorphismGroup(const AutomorphismGroup &);
+      AutomorphismGroup &operator=(const AutomorphismGroup &);
+
+    public:
+      AutomorphismGroup(int n);
+      ~AutomorphismGroup();
+
+      bool Search(State *s0, node_id phi[]);
+      int NodeCount() { return n; }
+      int GeneratorCount() { return gen_count; }
+      node_id *GetGenerator(int i) { return gen[i]; }
+      int BaseLen() { return base_len; }
+      node_id GetBaseNode(int d) { return base[d]; }
+      int BaseOrbitLen(int d) { return orbit_len[d]; }
+      node_id Orbit(node_id node);
+      bool SameOrbit(node_id a, node_id b)
+          { return Orbit(a)==Orbit(b); }
+      int OrbitSize(node_id node) { return orbit_size[Orbit(node)]; }
+      double Order();
+      int Visit(node_id phi[], match_visitor vis, void *usr_data=NULL);
+  };
+
+
+bool match_group(State *s0, node_id phi[], AutomorphismGroup *aut);
+
+int match_all(State *s0, match_visitor vis, void *usr_data=NULL);
+
+#endif
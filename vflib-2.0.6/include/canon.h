@@ -0,0 +1,72 @@
+/*------------------------------------------------------------------
+ * canon.h
+ * Header of canon.cc
+ * Declaration of the functions computing a canonical ordering
+ * of the nodes of a graph, and a certificate (a 128 bit hash
+ * of the graph in canonical form) for isomorphism tests.
+ * See: argraph.h reachcount.h
+ *-----------------------------------------------------------------*/
+
+
+/*-----------------------------------------------------------------
+ *   DESCRIPTION
+ * Two graphs are isomorphic if and only if their canonical
+ * forms are equal; so two graphs whose certificates differ
+ * are surely not isomorphic, and two graphs with the same
+ * certificate are isomorphic unless a hash collision has
+ * occurred (which has a negligible probability with 128
+ * bits; if needed, the isomorphism can be confirmed by
+ * comparing the graphs relabeled in canonical order, or with
+ * match()).
+ *
+ * The canonical form is found with the usual individualization
+ * and refinement scheme: the nodes are first partitioned into
+ * classes by invariant features (the node class, the in/out
+ * degrees and the reach counts of reachcount.h), and the
+ * partition is refined until the nodes in each class have the
+ * same number of neighbours in each class. If some class still
+ * has more than one node, each of its nodes is in turn put in a
+ * class of its own, and the refinement is repeated. Among the
+ * orders obtained when every class has a single node, the one
+ * giving the smallest relabeled graph is chosen. The branches
+ * equivalent under the automorphisms found so far, and the ones
+ * whose refinement invariants are worse than the best order,
+ * are not explored.
+ *
+ * The edge attributes are not considered. The node attributes
+ * are considered only through the optional function cls, which
+ * must return the same integer for compatible attributes.
+ *-----------------------------------------------------------------*/
+
+
+#ifndef CANON_H
+#define CANON_H
+
+#include "argraph.h"
+
+
+/*----------------------------------------------------------
+ * class GraphCertificate
+ * A 128 bit hash of a graph in canonical form
+ ---------------------------------------------------------*/
+class GraphCertificate
+  { public:
+      unsigned long long hi, lo;
+
+      bool operator==(const GraphCertificate &c) const
+          { return hi==c.hi && lo==c.lo; }
+      bool operator!=(const GraphCertificate &c) const
+          { return hi!=c.hi || lo!=c.lo; }
+      bool operator<(const GraphCertificate &c) const
+          { return hi<c.hi || (hi==c.hi && lo<c.lo); }
+  };
+
+
+typedef int (*node_class_fn)(void *attr);
+
+void CanonicalForm(Graph *g, node_id order[], GraphCertificate *cert,
+                   node_class_fn cls=NULL);
+
+GraphCertificate ComputeCertificate(Graph *g, node_class_fn cls=NULL);
+
+#endif
@@ -0,0 +1,58 @@
+/*------------------------------------------------------------------
+ * components.h
+ * Header of components.cc
+ * Declaration of the functions decomposing a graph into its
+ * weakly connected components, and matching two graphs one
+ * component at a time.
+ * See: argraph.h graphindex.h my_vf2_state.h
+ *-----------------------------------------------------------------*/
+
+
+/*-----------------------------------------------------------------
+ *   DESCRIPTION
+ * Two graphs are isomorphic if and only if their weakly
+ * connected components can be paired so that the components
+ * of each pair are isomorphic. component_match splits both
+ * graphs into components, each extracted as a separate graph,
+ * and gives each component the key of graphindex.h. If the
+ * multisets of the component sizes, or of the keys, differ,
+ * the graphs are rejected without searching. Otherwise the
+ * components are sorted by key, and each component of g1 is
+ * matched against the still unpaired components of g2 having
+ * the same key; since isomorphism is an equivalence, the first
+ * isomorphic one can be taken without backtracking.
+ * So a search over the whole graphs, where the features of
+ * MyVF2State do not distinguish the nodes of the different
+ * components, is replaced by several small searches.
+ *
+ * The groups of components having the same key are
+ * independent, and can be matched by several threads.
+ * The state used for each pair of components is built by
+ * the function make_state, by default a MyVF2State; the
+ * attribute comparators of g1 are used for the components
+ * too. The matching returned is the one of the whole graphs.
+ *-----------------------------------------------------------------*/
+
+
+#ifndef COMPONENTS_H
+#define COMPONENTS_H
+
+#include "argraph.h"
+#include "state.h"
+
+
+/*------------------------------------------------------------
+ * Definition of the component_state_fn type
+ * It returns a new initial state (allocated with new) to
+ * match the graphs g1 and g2; it may be called at the same
+ * time by different threads.
+ -----------------------------------------------------------*/
+typedef State *(*component_state_fn)(Graph *g1, Graph *g2);
+
+int WeakComponents(Graph *g, int comp[]);
+
+bool component_match(Graph *g1, Graph *g2,
+                     int *pn, node_id c1[], node_id c2[],
+                     int nthreads=1, component_state_fn make_state=NULL);
+
+#endif
@@ -0,0 +1,94 @@
+/*------------------------------------------------------------------
+ * csrgraph.h
+ * Header of csrgraph.cc
+ * Definition of a binary file format holding the edge vectors of
+ * a graph as stored by ARGraph_impl, and of the functions to
+ * write it and to map it in memory as a Graph.
+ * See: argraph.h argloader.h graphindex.h zstream.h
+ *-----------------------------------------------------------------*/
+
+
+/*-----------------------------------------------------------------
+ *   DESCRIPTION
+ * A CSR file contains the structure (not the attributes) of a
+ * graph in the compressed sparse row form used by ARGraph_impl:
+ *   - a header (csr_file_header) with a magic string, a mark of
+ *     the byte order, the size of node_id, some flags, the number
+ *     of nodes and of edges, and a checksum of the rest of the
+ *     file;
+ *   - the offsets of the out lists (n+1 32 bit ints);
+ *   - the offsets of the in lists (n+1 32 bit ints);
+ *   - the destinations of the out edges (m node ids);
+ *   - the sources of the in edges (m node ids);
+ *   - the position in the in lists of each out edge (m 32 bit
+ *     ints).
+ * Each vector is padded with zeros to a multiple of 8 bytes.
+ *
+ * MapCSRGraph maps the file with mmap and returns a Graph whose
+ * edge vectors point into the mapping: nothing is read or copied
+ * when the graph is opened, the pages are loaded when they are
+ * first used, and they are shared through the page cache by all
+ * the processes mapping the same file. Only the hash tables of
+ * the nodes with many edges (see argraph.h) are built in memory.
+ * The mapping is released when the graph is deleted. Attributes
+ * can be set on the graph as usual.
+ *
+ * The file is read in the byte order of the machine that wrote
+ * it; a file written with a different byte order or size of
+ * node_id is refused. Since it requires reading the whole file,
+ * the rest is tested only if requested: then the checksum is
+ * verified, and the structure too (the offsets must not
+ * decrease, the node ids must be less than the number of nodes
+ * and strictly increasing in each list, each out edge must refer
+ * to the corresponding in edge, and the flag CSR_UNDIRECTED must
+ * be set exactly when the in and out lists are equal).
+ * Without verification the contents of the file are trusted:
+ * a corrupted or forged file can make the graph read outside
+ * the mapping, or give wrong matchings.
+ *
+ * ConvertBinaryGraph converts a file read by BinaryGraphLoader
+ * (e.g. the .A00/.B00 files of the graph database, also if
+ * compressed with gzip or zstd, see zstream.h) into a CSR file:
+ *
+ *     ConvertBinaryGraph("si2_r001_s20.A00", "si2_r001_s20.csr");
+ *     ...
+ *     Graph *g=MapCSRGraph("si2_r001_s20.csr");
+ *     if (g==NULL)
+ *       ...
+ *     delete g;
+ *-----------------------------------------------------------------*/
+
+
+#ifndef CSRGRAPH_H
+#define CSRGRAPH_H
+
+#include <stdint.h>
+
+#include "argraph.h"
+
+
+/*----------------------------------------------------------
+ * struct csr_file_header
+ * The header of a CSR file
+ ---------------------------------------------------------*/
+struct csr_file_header
+  { char magic[8];
+    uint32_t byte_order;    // CSR_BYTE_ORDER, as written
+    uint32_t node_id_size;  // sizeof(node_id)
+    uint32_t flags;         // CSR_UNDIRECTED
+    uint32_t reserved;
+    uint64_t nodes;
+    uint64_t edges;
+    uint64_t checksum;      // of the vectors after the header
+  };
+
+enum { CSR_UNDIRECTED=1 };   // Each edge has its reverse
+const uint32_t CSR_BYTE_ORDER=0x01020304;
+
+
+bool WriteCSRGraph(const char *path, Graph *g);
+Graph *MapCSRGraph(const char *path, bool verify=false);
+bool ConvertBinaryGraph(const char *bin_path, const char *csr_path,
+                        int word_size=2);
+
+#endif
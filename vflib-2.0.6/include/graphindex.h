@@ -0,0 +1,147 @@
+/*------------------------------------------------------------------
+ * graphindex.h
+ * Header of graphindex.cc
+ * Definition of a class representing a collection of graphs,
+ * indexed by isomorphism invariants, to find the graphs of the
+ * collection isomorphic to a given graph.
+ * See: argraph.h my_vf2_state.h
+ *-----------------------------------------------------------------*/
+
+
+/*-----------------------------------------------------------------
+ *   DESCRIPTION
+ * For each graph the index stores a key made of invariants:
+ *   - the number of nodes and of edges;
+ *   - a hash of the sorted sequence of the (out, in) degrees;
+ *   - a hash of the sorted multiset of the distance profiles
+ *     of the nodes, where the profile of a node is the number
+ *     of nodes at each distance following the out edges, and
+ *     then the in edges. The features used by MyVF2State are
+ *     computed from the same distances, so this key separates
+ *     the graphs at least as well as the multiset of the VFD
+ *     features, without depending on floating point values;
+ *   - a hash of the classes of the nodes obtained refining the
+ *     classes of equal profile with the classes of the
+ *     neighbours, round after round until they are stable (as
+ *     in the colour refinement of the graph), which can
+ *     separate graphs having the same multiset of profiles.
+ * The entries are kept sorted by key, so the candidates for a
+ * query are found by binary search; then each candidate is
+ * verified with MyVF2Batch, which computes the features of
+ * the query only once.
+ *
+ * The structure of the graphs (not the attributes) is stored
+ * in the index too. Save writes the keys and the graphs in a
+ * single file, which Load maps in memory with mmap, so that
+ * a large index can be opened without reading it all.
+ * An index loaded from a file is copied in memory only if a
+ * new graph is added to it. Load checks the keys and the
+ * graphs of the file; Load(path, false) skips the check of
+ * the graphs, which reads the whole file, and should be used
+ * only for trusted files.
+ *-----------------------------------------------------------------*/
+
+
+#ifndef GRAPHINDEX_H
+#define GRAPHINDEX_H
+
+#include <stdint.h>
+#include <vector>
+
+#include "argraph.h"
+
+
+/*----------------------------------------------------------
+ * struct graph_index_key
+ * The invariants of a graph
+ ---------------------------------------------------------*/
+struct graph_index_key
+  { uint32_t nodes;
+    uint32_t edges;
+    uint64_t degree_hash;
+    uint64_t profile_hash;
+    uint64_t class_hash;
+
+    bool operator==(const graph_index_key &k) const
+        { return nodes==k.nodes && edges==k.edges &&
+                 degree_hash==k.degree_hash &&
+                 profile_hash==k.profile_hash &&
+                 class_hash==k.class_hash;
+        }
+    bool operator!=(const graph_index_key &k) const
+        { return !(*this==k); }
+    bool operator<(const graph_index_key &k) const
+        { if (nodes!=k.nodes)
+            return nodes<k.nodes;
+          if (edges!=k.edges)
+            return edges<k.edges;
+          if (degree_hash!=k.degree_hash)
+            return degree_hash<k.degree_hash;
+          if (profile_hash!=k.profile_hash)
+            return profile_hash<k.profile_hash;
+          return class_hash<k.class_hash;
+        }
+  };
+
+/*----------------------------------------------------------
+ * struct graph_index_entry
+ * An entry of the index, as stored in the file; data is the
+ * position of the graph in the data area, in node_id units.
+ ---------------------------------------------------------*/
+struct graph_index_entry
+  { graph_index_key key;
+    uint64_t data;
+  };
+
+
+/*----------------------------------------------------------
+ * class GraphIndex
+ ---------------------------------------------------------*/
+class GraphIndex
+  { private:
+      // The entries are kept in the order of insertion (the
+      // id of a graph is its position); order holds the ids
+      // sorted by key.
+      std::vector<graph_index_entry> entries;
+      std::vector<uint32_t> order;
+      std::vector<node_id> data;
+      bool sorted;
+
+      // The file mapped by Load, if any
+      void *map_addr;
+      size_t map_len;
+      const graph_index_entry *map_entries;
+      const uint32_t *map_order;
+      const node_id *map_data;
+      uint32_t map_count;
+
+      void unmap();
+      void copyMapped();
+      void sort();
+      void findKey(const graph_index_key *key, int *first, int *last);
+      int count() { return map_addr? (int)map_count: (int)entries.size(); }
+      const graph_index_entry *entry(int id)
+          { return map_addr? &map_entries[id]: &entries[id]; }
+      int sortedId(int i)
+          { return map_addr? (int)map_order[i]: (int)order[i]; }
+      const node_id *graphData(int id)
+          { return (map_addr? map_data: &data[0])+entry(id)->data; }
+
+    public:
+      GraphIndex();
+      ~GraphIndex();
+
+      int Add(Graph *g);
+      int Size() { return count(); }
+      int Candidates(Graph *g, int ids[], int max_ids);
+      int Find(Graph *g, int ids[], int max_ids);
+      Graph *GetGraph(int id);
+
+      bool Save(const char *path);
+      bool Load(const char *path, bool verify=true);
+  };
+
+
+void ComputeIndexKey(Graph *g, graph_index_key *key);
+
+#endif
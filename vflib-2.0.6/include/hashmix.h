@@ -0,0 +1,36 @@
+/*------------------------------------------------------------------
+ * hashmix.h
+ * Definition of the mixing function used to build the hashes of
+ * the invariants of the graphs.
+ * See: canon.h graphindex.h reduce.h
+ *-----------------------------------------------------------------*/
+
+
+/*-----------------------------------------------------------------
+ *   DESCRIPTION
+ * hash_mix is the finalizer of splitmix64: a bijection on 64 bit
+ * values, in which each bit of the result depends on all the bits
+ * of the argument. The hashes of sequences and multisets are
+ * built by combining the values with hash_mix, e.g.:
+ *
+ *     h=hash_mix(v.size());
+ *     for(i=0; i<v.size(); i++)
+ *       h=hash_mix(h^v[i]);
+ *-----------------------------------------------------------------*/
+
+
+#ifndef HASHMIX_H
+#define HASHMIX_H
+
+
+/*----------------------------------------------------------
+ * A bijective mixing function for 64 bit values
+ ---------------------------------------------------------*/
+static inline unsigned long long hash_mix(unsigned long long x)
+  { x+=0x9e3779b97f4a7c15ULL;
+    x=(x^(x>>30))*0xbf58476d1ce4e5b9ULL;
+    x=(x^(x>>27))*0x94d049bb133111ebULL;
+    return x^(x>>31);
+  }
+
+#endif
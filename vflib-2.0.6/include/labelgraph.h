@@ -0,0 +1,227 @@
+/*------------------------------------------------------------------
+ * labelgraph.h
+ * Definition of the class LabelledGraph, a graph whose node
+ * and edge attributes are small values (labels) stored inline
+ * next to the edge lists, and compared by template functors.
+ * See: argraph.h vf2_state.h my_vf2_state.h static_match.h
+ *-----------------------------------------------------------------*/
+
+
+/*-----------------------------------------------------------------
+ *   DESCRIPTION
+ * A LabelledGraph<NodeLabel, EdgeLabel> keeps a copy of the
+ * attributes of its nodes and edges in vectors parallel to the
+ * nodes and to the edge lists of ARGraph_impl, instead of
+ * pointers to objects allocated one by one. The labels are read
+ * from the loader: each attribute is taken as a pointer to a
+ * NodeLabel (or EdgeLabel), and a NULL attribute gives a default
+ * constructed label. The attributes of the loader are not owned
+ * by the graph. The labels should be small copyable values
+ * (e.g. ints or shorts).
+ *
+ * Two labels are compatible if the functor NodeCompat (or
+ * EdgeCompat) returns true, applied to the label of g1 and then
+ * to the one of g2; the default, EqualLabels, uses operator==.
+ *
+ * The non virtual methods GetNodeAttr, GetEdgeAttr, GetSlotAttr,
+ * GetOutEdge, GetInEdge, CompatibleNode and CompatibleEdge of LabelledGraph
+ * hide those of ARGraph_impl, and work on pointers to the
+ * labels. VF2TypedStaticState and MyVF2TypedStaticState call
+ * them, so that the test of the labels is inlined, without a
+ * virtual call or a pointer to an attribute object to follow:
+ *
+ *     typedef LabelledGraph<int, short> LGraph;
+ *     LGraph g1(&ed1), g2(&ed2);
+ *     MyVF2TypedStaticState<LGraph> s0(&g1, &g2);
+ *     if (match(&s0, &n, c1, c2))        // see static_match.h
+ *       ...
+ *
+ * Through the interface of ARGraph_impl (e.g. with any other
+ * state) the graph behaves as one whose attributes point to the
+ * labels, with comparators applying NodeCompat and EdgeCompat.
+ *-----------------------------------------------------------------*/
+
+
+#ifndef LABELGRAPH_H
+#define LABELGRAPH_H
+
+#include <stddef.h>
+#include <assert.h>
+#include <vector>
+
+#include "argraph.h"
+
+
+/*----------------------------------------------------------
+ * class EqualLabels
+ * The default compatibility functor: equal labels
+ ---------------------------------------------------------*/
+template <class T>
+class EqualLabels
+  { public:
+      bool operator()(const T &a, const T &b) const { return a==b; }
+  };
+
+
+/*----------------------------------------------------------
+ * class LabelComparator
+ * An AttrComparator applying the functor Compat to the
+ * labels pointed to by the attributes
+ ---------------------------------------------------------*/
+template <class T, class Compat>
+class LabelComparator: public AttrComparator
+  { public:
+      virtual bool compatible(void *attr1, void *attr2)
+          { return Compat()(*(T*)attr1, *(T*)attr2); }
+  };
+
+
+/*----------------------------------------------------------
+ * class LabelLoader
+ * Copies the labels and the edges of a loader; acts as the
+ * loader of a LabelledGraph, with attributes pointing to the
+ * copied labels
+ ---------------------------------------------------------*/
+template <class NodeLabel, class EdgeLabel>
+class LabelLoader: public ARGLoader
+  { public:
+      std::vector<NodeLabel> node_label;
+      std::vector<EdgeLabel> out_label; // Labels of the 'out' edges,
+                                        // in the order of the loader
+      std::vector<int> out_start;       // Used only during the
+      std::vector<node_id> out_node;    // construction of the graph
+
+      LabelLoader(ARGLoader *loader);
+      int NodeCount() { return node_label.size(); }
+      void *GetNodeAttr(node_id node) { return &node_label[node]; }
+      int OutEdgeCount(node_id node)
+          { return out_start[node+1]-out_start[node]; }
+      node_id GetOutEdge(node_id node, int i, void **pattr)
+          { int k=out_start[node]+i;
+            *pattr=&out_label[k];
+            return out_node[k];
+          }
+  };
+
+/*----------------------------------------------------------
+ * Holds the LabelLoader, so that it is built before the
+ * ARGraph_impl part of a LabelledGraph
+ ---------------------------------------------------------*/
+template <class NodeLabel, class EdgeLabel>
+class LabelHolder
+  { protected:
+      LabelLoader<NodeLabel, EdgeLabel> labels;
+      LabelHolder(ARGLoader *loader): labels(loader) {}
+  };
+
+
+/*----------------------------------------------------------
+ * class LabelledGraph
+ * A graph with inline node and edge labels
+ ---------------------------------------------------------*/
+template <class NodeLabel, class EdgeLabel,
+          class NodeCompat=EqualLabels<NodeLabel>,
+          class EdgeCompat=EqualLabels<EdgeLabel> >
+class LabelledGraph: private LabelHolder<NodeLabel, EdgeLabel>,
+                     public ARGraph_impl
+  { private:
+      std::vector<EdgeLabel> in_label;  // Labels of the 'in' edges
+
+    public:
+      typedef NodeLabel node_label_type;
+      typedef EdgeLabel edge_label_type;
+      typedef const EdgeLabel *edge_attr_type;
+
+      LabelledGraph(ARGLoader *loader);
+
+      using ARGraph_impl::GetOutEdge;
+      using ARGraph_impl::GetInEdge;
+
+      const NodeLabel *GetNodeAttr(node_id i)
+          { assert(i<(node_id)n);
+            return &this->labels.node_label[i];
+          }
+      const EdgeLabel *GetEdgeAttr(node_id n1, node_id n2)
+          { int k=FindEdge(n1, n2);
+            return k<0? NULL: &this->labels.out_label[k];
+          }
+      const EdgeLabel *GetSlotAttr(int slot)
+          { return &this->labels.out_label[slot]; }
+      node_id GetOutEdge(node_id node, int i, const EdgeLabel **pattr)
+          { assert(node<(node_id)n);
+            int k=out_start[node]+i;
+            *pattr=&this->labels.out_label[k];
+            return out_node[k];
+          }
+      node_id GetInEdge(node_id node, int i, const EdgeLabel **pattr)
+          { assert(node<(node_id)n);
+            int k=in_start[node]+i;
+            *pattr=&in_label[k];
+            return in_node[k];
+          }
+
+      bool CompatibleNode(const NodeLabel *attr1, const NodeLabel *attr2)
+          { return NodeCompat()(*attr1, *attr2); }
+      bool CompatibleEdge(const EdgeLabel *attr1, const EdgeLabel *attr2)
+          { return EdgeCompat()(*attr1, *attr2); }
+  };
+
+
+/*---------------------------------------------------------------------
+ * IMPLEMENTATION
+ ---------------------------------------------------------------------*/
+
+/*----------------------------------------------------------
+ * LabelLoader::LabelLoader(loader)
+ * Constructor. Copies the labels and the edges of loader.
+ ---------------------------------------------------------*/
+template <class NodeLabel, class EdgeLabel>
+LabelLoader<NodeLabel, EdgeLabel>::LabelLoader(ARGLoader *loader)
+  { int n=loader->NodeCount();
+    int i, k;
+    node_label.resize(n);
+    out_start.resize(n+1);
+    out_start[0]=0;
+    for(i=0; i<n; i++)
+      { void *a=loader->GetNodeAttr(i);
+        if (a!=NULL)
+          node_label[i]=*(NodeLabel*)a;
+        out_start[i+1]=out_start[i]+loader->OutEdgeCount(i);
+      }
+    out_label.resize(out_start[n]);
+    out_node.resize(out_start[n]);
+    for(i=0; i<n; i++)
+      for(k=out_start[i]; k<out_start[i+1]; k++)
+        { void *a;
+          out_node[k]=loader->GetOutEdge(i, k-out_start[i], &a);
+          if (a!=NULL)
+            out_label[k]=*(EdgeLabel*)a;
+        }
+  }
+
+
+/*----------------------------------------------------------
+ * LabelledGraph::LabelledGraph(loader)
+ * Constructor. The labels of the 'in' edges are copied from
+ * the ones of the 'out' edges, through the attributes
+ * transposed by ARGraph_impl.
+ ---------------------------------------------------------*/
+template <class NodeLabel, class EdgeLabel, class NodeCompat,
+          class EdgeCompat>
+LabelledGraph<NodeLabel, EdgeLabel, NodeCompat, EdgeCompat>::
+LabelledGraph(ARGLoader *loader)
+  : LabelHolder<NodeLabel, EdgeLabel>(loader),
+    ARGraph_impl(&this->labels)
+  { int k, m=out_start[n];
+    in_label.resize(m);
+    for(k=0; k<m; k++)
+      in_label[k]=*(EdgeLabel*)in_attr[k];
+    std::vector<int>().swap(this->labels.out_start);
+    std::vector<node_id>().swap(this->labels.out_node);
+
+    SetNodeComparator(new LabelComparator<NodeLabel, NodeCompat>());
+    SetEdgeComparator(new LabelComparator<EdgeLabel, EdgeCompat>());
+  }
+
+
+#endif
@@ -0,0 +1,131 @@
+/*------------------------------------------------------------------
+ * matchengine.h
+ * Header of matchengine.cc
+ * Definition of a class performing the depth-first search of
+ * the match functions without recursion, so that the search
+ * can be suspended and resumed.
+ * See: match.h state.h
+ *-----------------------------------------------------------------*/
+
+
+/*-----------------------------------------------------------------
+ *   DESCRIPTION
+ * A MatchEngine visits the SSR starting from an initial state,
+ * in the same order as the match functions of match.h, keeping
+ * the search path in a vector of frames instead of the C++
+ * stack. Each frame holds a state and the last pair tried
+ * from it.
+ * The method Run performs at most a given number of steps (a
+ * step is the visit of a new state, or the attempt of a
+ * candidate pair), and returns:
+ *   MATCH_FOUND      if a goal state has been reached; the
+ *                    matching can be read with GetCoreSet, and
+ *                    a further call to Run continues the search
+ *                    looking for the next match;
+ *   MATCH_EXHAUSTED  if the whole SSR has been visited; then
+ *                    CoreLen returns 0 and GetCoreSet does
+ *                    nothing;
+ *   MATCH_SUSPENDED  if the limit on the steps has been reached;
+ *                    a further call to Run resumes the search.
+ * The initial state is not owned by the engine, and must not
+ * be used until the engine is destroyed.
+ *
+ * MatchIterator is a simpler interface to MatchEngine, for the
+ * callers that only want the matches one at a time, e.g.:
+ *     MatchIterator it(&s0);
+ *     while (it.Next(&n, c1, c2))
+ *       ...
+ * Each call to Next continues the search from the point where
+ * the previous match was found.
+ *-----------------------------------------------------------------*/
+
+
+#ifndef MATCHENGINE_H
+#define MATCHENGINE_H
+
+#include "argraph.h"
+#include "state.h"
+
+
+enum { MATCH_FOUND, MATCH_EXHAUSTED, MATCH_SUSPENDED };
+
+
+/*----------------------------------------------------------
+ * class MatchEngine
+ * An iterative, resumable depth-first search on the SSR
+ ---------------------------------------------------------*/
+class MatchEngine
+  { private:
+      struct frame
+        { State *s;
+          node_id n1, n2;   // Last pair tried from s
+          bool visited;     // true if IsGoal/IsDead have been checked
+        };
+
+      frame *stack;
+      int top;
+      int stack_size;
+      bool at_goal;
+      long step_count;
+
+      void push(State *s);
+      void pop();
+
+    public:
+      MatchEngine(State *s0);
+      ~MatchEngine();
+
+      int Run(long max_steps=0);
+      long StepCount() { return step_count; }
+      int Depth() { return top; }
+      int CoreLen() { return top>=0? stack[top].s->CoreLen(): 0; }
+      void GetCoreSet(node_id c1[], node_id c2[])
+          { if (top>=0)
+              stack[top].s->GetCoreSet(c1, c2);
+          }
+  };
+
+
+/*----------------------------------------------------------
+ * class MatchIterator
+ * Returns the matches one at a time
+ ---------------------------------------------------------*/
+class MatchIterator
+  { private:
+      MatchEngine engine;
+      bool done;
+      int count;
+
+    public:
+      MatchIterator(State *s0) : engine(s0) { done=false; count=0; }
+      bool Next(int *pn, node_id c1[], node_id c2[]);
+      int Count() { return count; }
+  };
+
+
+/*---------------------------------------------------------------------
+ * INLINE METHODS
+ ---------------------------------------------------------------------*/
+
+/*----------------------------------------------------------
+ * bool MatchIterator::Next(pn, c1, c2)
+ * Searches the next match. Returns false if there are no
+ * more matches; otherwise *pn is assigned the number of
+ * matched nodes, and c1 and c2 will contain the ids of the
+ * corresponding nodes in the two graphs.
+ ---------------------------------------------------------*/
+inline bool MatchIterator::Next(int *pn, node_id c1[], node_id c2[])
+  { if (done)
+      return false;
+    if (engine.Run()!=MATCH_FOUND)
+      { done=true;
+        return false;
+      }
+    *pn=engine.CoreLen();
+    engine.GetCoreSet(c1, c2);
+    count++;
+    return true;
+  }
+
+
+#endif
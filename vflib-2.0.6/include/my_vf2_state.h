@@ -0,0 +1,769 @@
+/*------------------------------------------------------------
+ * my_vf2_state.h
+ * Interface of my_vf2_state.cc
+ * Definition of a class representing a state of the matching
+ * process between two ARGs using the VFD algorithm, a variant
+ * of VF2 pruning the candidate pairs by means of node features
+ * derived from the distances between nodes.
+ * See: argraph.h state.h static_state.h vf2_state.h
+ *-----------------------------------------------------------------*/
+
+
+
+
+#ifndef MYVF2_STATE_H
+#define MYVF2_STATE_H
+
+#include <math.h>
+
+#include "argraph.h"
+#include "state.h"
+#include "match.h"
+#include "static_state.h"
+
+
+class MyVF2Batch;
+
+
+/*----------------------------------------------------------
+ * class MyVF2StaticState
+ * A representation of the SSR current state, with no
+ * virtual methods; to be used with the template functions
+ * of static_match.h.
+ * See my_vf2_state.cc for more details.
+ ---------------------------------------------------------*/
+class MyVF2StaticState
+  { typedef ARGraph_impl Graph;
+
+    private:
+      int core_len, orig_core_len;
+      int added_node1;
+      int t1both_len, t2both_len, t1in_len, t1out_len, 
+          t2in_len, t2out_len; // Core nodes are also counted by these...
+      node_id *core_1;
+      node_id *core_2;
+      node_id *in_1;
+      node_id *in_2;
+      node_id *out_1;
+      node_id *out_2;
+      node_id *order;
+
+      Graph *g1, *g2;
+      int n1, n2;
+      bool undirected;    // If true, in_1/in_2 are not used
+
+	  long *share_count;
+      bool owns_arrays;   // false if the vectors belong to a MyVF2Batch
+
+	  double *features1, *features2;
+
+      bool nextPairUndirected(node_id *pn1, node_id *pn2,
+                              node_id prev_n1, node_id prev_n2);
+      template <class G>
+      bool isFeasiblePairUndirected(G *g1, G *g2, node_id n1, node_id n2);
+      void addPairUndirected(node_id n1, node_id n2);
+      void backTrackUndirected();
+    
+    public:
+      MyVF2StaticState(Graph *g1, Graph *g2, bool sortNodes=false);
+      MyVF2StaticState(MyVF2Batch *batch, Graph *g2);
+      MyVF2StaticState(const MyVF2StaticState &state);
+      ~MyVF2StaticState(); 
+      Graph *GetGraph1() { return g1; }
+      Graph *GetGraph2() { return g2; }
+      bool NextPair(node_id *pn1, node_id *pn2,
+                    node_id prev_n1=NULL_NODE, node_id prev_n2=NULL_NODE);
+      bool IsFeasiblePair(node_id n1, node_id n2)
+          { return isFeasiblePair(g1, g2, n1, n2); }
+      void AddPair(node_id n1, node_id n2);
+      bool IsGoal() { return core_len==n1 && core_len==n2; };
+      bool IsDead() { return  (undirected? t1out_len!=t2out_len
+                                         : t1both_len!=t2both_len) ||
+                              n1!=n2;
+                    };
+      int CoreLen() { return core_len; }
+      void GetCoreSet(node_id c1[], node_id c2[]);
+
+	  void BackTrack();
+
+    protected:
+      template <class G>
+      bool isFeasiblePair(G *g1, G *g2, node_id node1, node_id node2);
+  };
+
+
+/*----------------------------------------------------------
+ * class MyVF2State
+ * The State interface to MyVF2StaticState.
+ ---------------------------------------------------------*/
+class MyVF2State: public StateAdapter<MyVF2StaticState, MyVF2State>
+  { public:
+      MyVF2State(Graph *g1, Graph *g2, bool sortNodes=false)
+        : StateAdapter<MyVF2StaticState, MyVF2State>(g1, g2, sortNodes) {}
+  };
+
+
+/*----------------------------------------------------------
+ * class MyVF2TypedStaticState
+ * A MyVF2StaticState for two graphs of the class G, derived
+ * from ARGraph_impl (e.g. a LabelledGraph of labelgraph.h),
+ * which tests the compatibility of the attributes through
+ * the non virtual methods of G, so that they can be inlined.
+ ---------------------------------------------------------*/
+template <class G>
+class MyVF2TypedStaticState: public MyVF2StaticState
+  { public:
+      MyVF2TypedStaticState(G *g1, G *g2, bool sortNodes=false)
+        : MyVF2StaticState(g1, g2, sortNodes) {}
+      bool IsFeasiblePair(node_id n1, node_id n2)
+          { return isFeasiblePair(static_cast<G*>(GetGraph1()),
+                                  static_cast<G*>(GetGraph2()), n1, n2); }
+  };
+
+
+/*----------------------------------------------------------
+ * class MyVF2Query
+ * The part of the initial state of MyVF2StaticState that
+ * depends only on g1 (the query): the node features and the
+ * node order. It is computed once, and can be shared by
+ * several MyVF2Batch objects.
+ ---------------------------------------------------------*/
+class MyVF2Query
+  { friend class MyVF2StaticState;
+    friend class MyVF2Batch;
+
+    private:
+      Graph *g;
+      int n;
+      int edges;
+      double *features;
+      double *sorted_features;
+      node_id *order;
+
+    public:
+      MyVF2Query(Graph *g, bool sortNodes=false);
+      ~MyVF2Query();
+      Graph *GetGraph() { return g; }
+  };
+
+
+/*----------------------------------------------------------
+ * class MyVF2Batch
+ * Matches a prepared query against a sequence of targets,
+ * reusing the vectors of the state from one target to the
+ * next. The targets that differ from the query in the
+ * number of nodes or edges, or in the multiset of the node
+ * features, are rejected without searching.
+ * A MyVF2Batch must be used by one thread at a time.
+ ---------------------------------------------------------*/
+class MyVF2Batch
+  { friend class MyVF2StaticState;
+
+    private:
+      MyVF2Query *query;
+      int size2;
+      node_id *core_1, *in_1, *out_1;
+      node_id *core_2, *in_2, *out_2;
+      double *features2, *sorted2;
+      long reject_count;
+
+      bool prepare(Graph *g2);
+
+    public:
+      MyVF2Batch(MyVF2Query *query);
+      ~MyVF2Batch();
+      bool Match(Graph *g2, int *pn, node_id c1[], node_id c2[]);
+      int Match(Graph *g2, match_visitor vis, void *usr_data=NULL);
+      long RejectCount() { return reject_count; }
+  };
+
+
+/*---------------------------------------------------------------------
+ * INLINE METHODS
+ ---------------------------------------------------------------------*/
+
+/*----------------------------------------------------------
+ * MyVF2StaticState::MyVF2StaticState(state)
+ * Copy constructor. 
+ ---------------------------------------------------------*/
+inline MyVF2StaticState::MyVF2StaticState(const MyVF2StaticState &state)
+  { g1=state.g1;
+    g2=state.g2;
+    n1=state.n1;
+    n2=state.n2;
+    undirected=state.undirected;
+
+    order=state.order;
+
+    core_len=orig_core_len=state.core_len;
+    t1in_len=state.t1in_len;
+    t1out_len=state.t1out_len;
+    t1both_len=state.t1both_len;
+    t2in_len=state.t2in_len;
+    t2out_len=state.t2out_len;
+    t2both_len=state.t2both_len;
+	if(n1==n2){
+        features1 = state.features1;
+        features2 = state.features2;
+	}
+    added_node1=NULL_NODE;
+
+    core_1=state.core_1;
+    core_2=state.core_2;
+    in_1=state.in_1;
+    in_2=state.in_2;
+    out_1=state.out_1;
+    out_2=state.out_2;
+    share_count=state.share_count;
+    owns_arrays=state.owns_arrays;
+
+    if (owns_arrays)
+      ++ *share_count;
+
+  }
+
+
+/*---------------------------------------------------------------
+ * MyVF2StaticState::~MyVF2StaticState()
+ * Destructor.
+ --------------------------------------------------------------*/
+inline MyVF2StaticState::~MyVF2StaticState() 
+  { if (owns_arrays && -- *share_count == 0)
+    { delete [] core_1;
+      delete [] core_2;
+      delete [] in_1;
+      delete [] out_1;
+      delete [] in_2;
+      delete [] out_2;
+      delete share_count;
+	  if(n1==n2){
+		delete [] features1;
+		delete [] features2;
+      }
+      delete [] order;
+	}
+  }
+
+
+/*--------------------------------------------------------------------------
+ * bool MyVF2StaticState::NextPair(pn1, pn2, prev_n1, prev_n2)
+ * Puts in *pn1, *pn2 the next pair of nodes to be tried.
+ * prev_n1 and prev_n2 must be the last nodes, or NULL_NODE (default)
+ * to start from the first pair.
+ * Returns false if no more pairs are available.
+ -------------------------------------------------------------------------*/
+
+inline bool MyVF2StaticState::NextPair(node_id *pn1, node_id *pn2,
+              node_id prev_n1, node_id prev_n2)
+  { if (undirected)
+      return nextPairUndirected(pn1, pn2, prev_n1, prev_n2);
+
+    if (prev_n1==NULL_NODE)
+      prev_n1=0;
+
+    if (prev_n2==NULL_NODE)
+      prev_n2=0;
+    else
+      prev_n2++;
+
+	if (t1both_len>core_len && t2both_len>core_len)
+	  { while (prev_n1<(node_id)n1 &&
+           (core_1[prev_n1]!=NULL_NODE || out_1[prev_n1]==0
+		            || in_1[prev_n1]==0))
+          { prev_n1++;    
+            prev_n2=0;
+          }
+	  }
+	else if (t1out_len>core_len && t2out_len>core_len)
+	  { while (prev_n1<(node_id)n1 &&
+           (core_1[prev_n1]!=NULL_NODE || out_1[prev_n1]==0))
+          { prev_n1++;    
+            prev_n2=0;
+          }
+	  }
+    else if (t1in_len>core_len && t2in_len>core_len)
+	  { while (prev_n1<(node_id)n1 &&
+           (core_1[prev_n1]!=NULL_NODE || in_1[prev_n1]==0))
+          { prev_n1++;    
+            prev_n2=0;
+          }
+	  }
+	else if (prev_n1==0 && order!=NULL)
+	  { int i=0;
+	    while (i<n1 && core_1[prev_n1=order[i]]!=NULL_NODE)
+	      i++;
+	    if (i==n1)
+	      prev_n1=n1;
+	  }
+	else
+	  { while (prev_n1<(node_id)n1 && core_1[prev_n1]!=NULL_NODE )
+          { prev_n1++;    
+            prev_n2=0;
+          }
+	  }
+
+
+	if (t1both_len>core_len && t2both_len>core_len)
+	  { while (prev_n2<(node_id)n2 &&
+           (core_2[prev_n2]!=NULL_NODE || out_2[prev_n2]==0
+		            || in_2[prev_n2]==0 ||fabs(features1[prev_n1]-features2[prev_n2])>0.00000001))
+          { prev_n2++;    
+          }
+	  }
+	else if (t1out_len>core_len && t2out_len>core_len)
+	  { while (prev_n2<(node_id)n2 &&
+           (core_2[prev_n2]!=NULL_NODE || out_2[prev_n2]==0 || fabs(features1[prev_n1]-features2[prev_n2])>0.00000001))
+          { prev_n2++;    
+          }
+	  }
+    else if (t1in_len>core_len && t2in_len>core_len)
+	  { while (prev_n2<(node_id)n2 &&
+           (core_2[prev_n2]!=NULL_NODE || in_2[prev_n2]==0 || fabs(features1[prev_n1]-features2[prev_n2])>0.00000001))
+          { prev_n2++;    
+          }
+	  }
+	else
+	  { while (prev_n2<(node_id)n2 && (core_2[prev_n2]!=NULL_NODE || fabs(features1[prev_n1]-features2[prev_n2])>0.00000001))
+          { prev_n2++;    
+          }
+	  }
+	  
+
+    if (prev_n1<(node_id)n1 && prev_n2<(node_id)n2)
+          { *pn1=prev_n1;
+            *pn2=prev_n2;
+            return true;
+          }
+
+    return false;
+  }
+
+/*---------------------------------------------------------------
+ * bool MyVF2StaticState::isFeasiblePair(g1, g2, node1, node2)
+ * Returns true if (node1, node2) can be added to the state;
+ * g1 and g2 are the graphs of the state, seen as graphs of
+ * the class G.
+ * NOTE: 
+ *   The attribute compatibility check (methods CompatibleNode
+ *   and CompatibleEdge of ARGraph) is always performed
+ *   applying the method to g1, and passing the attribute of
+ *   g1 as first argument, and the attribute of g2 as second
+ *   argument. This may be important if the compatibility
+ *   criterion is not symmetric.
+ --------------------------------------------------------------*/
+
+template <class G>
+inline bool MyVF2StaticState::isFeasiblePair(G *g1, G *g2,
+                                             node_id node1, node_id node2)
+  { assert(node1<(node_id)n1);
+    assert(node2<(node_id)n2);
+    assert(core_1[node1]==NULL_NODE);
+    assert(core_2[node2]==NULL_NODE);
+
+    if (undirected)
+      return isFeasiblePairUndirected(g1, g2, node1, node2);
+
+    if (!g1->CompatibleNode(g1->GetNodeAttr(node1), g2->GetNodeAttr(node2)))
+      return false;
+	
+    int i, other1, other2;
+    typename G::edge_attr_type attr1;
+    int termout1out=0, termout2out=0, termin1out=0, termin2out=0, termout1in=0, termout2in=0, termin1in=0, termin2in=0;
+	
+	if(g1->OutEdgeCount(node1)!=g2->OutEdgeCount(node2) || g1->InEdgeCount(node1)!=g2->InEdgeCount(node2))
+		return false;
+    // Check the 'out' edges of node1
+    for(i=0; i<g1->OutEdgeCount(node1); i++)
+      { other1=g1->GetOutEdge(node1, i, &attr1);
+        if (core_1[other1] != NULL_NODE)
+          { other2=core_1[other1];
+            int e=g2->FindEdge(node2, other2);
+            if (e<0 || !g1->CompatibleEdge(attr1, g2->GetSlotAttr(e)))
+              return false;
+          }
+        else 
+          { if (in_1[other1])
+              termin1out++;
+            if (out_1[other1])
+              termout1out++;
+           // if (!in_1[other1] && !out_1[other1])
+            //  newout1++;
+          }
+      }
+
+    // Check the 'in' edges of node1
+    for(i=0; i<g1->InEdgeCount(node1); i++)
+      { other1=g1->GetInEdge(node1, i, &attr1);
+        if (core_1[other1]!=NULL_NODE)
+          { other2=core_1[other1];
+            int e=g2->FindEdge(other2, node2);
+            if (e<0 || !g1->CompatibleEdge(attr1, g2->GetSlotAttr(e)))
+              return false;
+          }
+        else 
+          { if (in_1[other1])
+              termin1in++;
+            if (out_1[other1])
+              termout1in++;
+            //if (!in_1[other1] && !out_1[other1])
+             // newin1++;
+          }
+      }
+
+
+    // Check the 'out' edges of node2
+    for(i=0; i<g2->OutEdgeCount(node2); i++)
+      { other2=g2->GetOutEdge(node2, i);
+        if (core_2[other2]!=NULL_NODE)
+          { other1=core_2[other2];
+            if (!g1->HasEdge(node1, other1))
+              return false;
+          }
+        else 
+          { if (in_2[other2])
+              termin2out++;
+            if (out_2[other2])
+              termout2out++;
+           // if (!in_2[other2] && !out_2[other2])
+            //  newout2++;
+          }
+      }
+
+    // Check the 'in' edges of node2
+    for(i=0; i<g2->InEdgeCount(node2); i++)
+      { other2=g2->GetInEdge(node2, i);
+        if (core_2[other2] != NULL_NODE)
+          { other1=core_2[other2];
+            if (!g1->HasEdge(other1, node1))
+              return false;
+          }
+        else 
+          { if (in_2[other2])
+              termin2in++;
+            if (out_2[other2])
+              termout2in++;
+           // if (!in_2[other2] && !out_2[other2])
+           //   newin2++;
+          }
+      }
+
+    return  termin1out==termin2out && termout1out==termout2out && termout1in==termout2in &&termin1in==termin2in;
+  }
+  
+/*--------------------------------------------------------------
+ * void MyVF2StaticState::AddPair(node1, node2)
+ * Adds a pair to the Core set of the state.
+ * Precondition: the pair must be feasible
+ -------------------------------------------------------------*/
+inline void MyVF2StaticState::AddPair(node_id node1, node_id node2)
+  { assert(node1<(node_id)n1);
+    assert(node2<(node_id)n2);
+    assert(core_len<n1);
+    assert(core_len<n2);
+
+    if (undirected)
+      { addPairUndirected(node1, node2);
+        return;
+      }
+
+    core_len++;
+	added_node1=node1;
+
+	if (!in_1[node1])
+	  { in_1[node1]=core_len;
+	    t1in_len++;
+		if (out_1[node1])
+		  t1both_len++;
+	  }
+	if (!out_1[node1])
+	  { out_1[node1]=core_len;
+	    t1out_len++;
+		if (in_1[node1])
+		  t1both_len++;
+	  }
+
+	if (!in_2[node2])
+	  { in_2[node2]=core_len;
+	    t2in_len++;
+		if (out_2[node2])
+		  t2both_len++;
+	  }
+	if (!out_2[node2])
+	  { out_2[node2]=core_len;
+	    t2out_len++;
+		if (in_2[node2])
+		  t2both_len++;
+	  }
+
+    core_1[node1]=node2;
+    core_2[node2]=node1;
+
+
+    int i, other;
+    for(i=0; i<g1->InEdgeCount(node1); i++)
+      { other=g1->GetInEdge(node1, i);
+        if (!in_1[other])
+          { in_1[other]=core_len;
+            t1in_len++;
+		    if (out_1[other])
+		      t1both_len++;
+          }
+      }
+
+    for(i=0; i<g1->OutEdgeCount(node1); i++)
+      { other=g1->GetOutEdge(node1, i);
+        if (!out_1[other])
+          { out_1[other]=core_len;
+            t1out_len++;
+		    if (in_1[other])
+		      t1both_len++;
+          }
+      }
+    
+    for(i=0; i<g2->InEdgeCount(node2); i++)
+      { other=g2->GetInEdge(node2, i);
+        if (!in_2[other])
+          { in_2[other]=core_len;
+            t2in_len++;
+		    if (out_2[other])
+		      t2both_len++;
+          }
+      }
+
+    for(i=0; i<g2->OutEdgeCount(node2); i++)
+      { other=g2->GetOutEdge(node2, i);
+        if (!out_2[other])
+          { out_2[other]=core_len;
+            t2out_len++;
+		    if (in_2[other])
+		      t2both_len++;
+          }
+      }
+
+  }
+
+
+
+/*----------------------------------------------------------------
+ * Undoes the changes to the shared vectors made by the 
+ * current state. Assumes that at most one AddPair has been
+ * performed.
+ ----------------------------------------------------------------*/
+inline void MyVF2StaticState::BackTrack()
+  { assert(core_len - orig_core_len <= 1);
+    assert(added_node1 != (int)NULL_NODE);
+
+    if (undirected)
+      { backTrackUndirected();
+        return;
+      }
+  
+    if (orig_core_len < core_len)
+      { int i, node2;
+
+        if (in_1[added_node1] == (node_id)core_len)
+		  in_1[added_node1] = 0;
+	    for(i=0; i<g1->InEdgeCount(added_node1); i++)
+		  { int other=g1->GetInEdge(added_node1, i);
+		    if (in_1[other]==(node_id)core_len)
+			  in_1[other]=0;
+		  }
+        
+		if (out_1[added_node1] == (node_id)core_len)
+		  out_1[added_node1] = 0;
+	    for(i=0; i<g1->OutEdgeCount(added_node1); i++)
+		  { int other=g1->GetOutEdge(added_node1, i);
+		    if (out_1[other]==(node_id)core_len)
+			  out_1[other]=0;
+		  }
+	    
+		node2 = core_1[added_node1];
+
+        if (in_2[node2] == (node_id)core_len)
+		  in_2[node2] = 0;
+	    for(i=0; i<g2->InEdgeCount(node2); i++)
+		  { int other=g2->GetInEdge(node2, i);
+		    if (in_2[other]==(node_id)core_len)
+			  in_2[other]=0;
+		  }
+        
+		if (out_2[node2] == (node_id)core_len)
+		  out_2[node2] = 0;
+	    for(i=0; i<g2->OutEdgeCount(node2); i++)
+		  { int other=g2->GetOutEdge(node2, i);
+		    if (out_2[other]==(node_id)core_len)
+			  out_2[other]=0;
+		  }
+	    
+	    core_1[added_node1] = NULL_NODE;
+		core_2[node2] = NULL_NODE;
+	    
+	    core_len=orig_core_len;
+		added_node1 = NULL_NODE;
+	  }
+
+  }
+
+
+/*--------------------------------------------------------------------------
+ * Undirected versions of NextPair, IsFeasiblePair, AddPair and
+ * BackTrack, used when both graphs are undirected (see
+ * ARGraph_impl::IsUndirected) and have no edge attributes. The
+ * in and out neighbours of each node are the same, so the in and
+ * out terminal sets would be equal too: only the out lists and
+ * the out vectors are used.
+ -------------------------------------------------------------------------*/
+inline bool MyVF2StaticState::nextPairUndirected(node_id *pn1, node_id *pn2,
+              node_id prev_n1, node_id prev_n2)
+  { if (prev_n1==NULL_NODE)
+      prev_n1=0;
+
+    if (prev_n2==NULL_NODE)
+      prev_n2=0;
+    else
+      prev_n2++;
+
+    bool term=t1out_len>core_len && t2out_len>core_len;
+    if (term)
+      { while (prev_n1<(node_id)n1 &&
+               (core_1[prev_n1]!=NULL_NODE || out_1[prev_n1]==0))
+          { prev_n1++;
+            prev_n2=0;
+          }
+      }
+    else if (prev_n1==0 && order!=NULL)
+      { int i=0;
+        while (i<n1 && core_1[prev_n1=order[i]]!=NULL_NODE)
+          i++;
+        if (i==n1)
+          prev_n1=n1;
+      }
+    else
+      { while (prev_n1<(node_id)n1 && core_1[prev_n1]!=NULL_NODE)
+          { prev_n1++;
+            prev_n2=0;
+          }
+      }
+
+    if (prev_n1>=(node_id)n1)
+      return false;
+    double f1=features1[prev_n1];
+    while (prev_n2<(node_id)n2 &&
+           (core_2[prev_n2]!=NULL_NODE || (term && out_2[prev_n2]==0) ||
+            fabs(f1-features2[prev_n2])>0.00000001))
+      prev_n2++;
+
+    if (prev_n2<(node_id)n2)
+      { *pn1=prev_n1;
+        *pn2=prev_n2;
+        return true;
+      }
+    return false;
+  }
+
+template <class G>
+inline bool MyVF2StaticState::isFeasiblePairUndirected(G *g1, G *g2,
+                                                       node_id node1,
+                                                       node_id node2)
+  { if (!g1->CompatibleNode(g1->GetNodeAttr(node1), g2->GetNodeAttr(node2)))
+      return false;
+
+    int deg=g1->OutEdgeCount(node1);
+    if (deg!=g2->OutEdgeCount(node2))
+      return false;
+
+    int i, other1, other2;
+    typename G::edge_attr_type attr1;
+    int core1=0, core2=0, term1=0, term2=0;
+
+    for(i=0; i<deg; i++)
+      { other1=g1->GetOutEdge(node1, i, &attr1);
+        if (core_1[other1]!=NULL_NODE)
+          { other2=core_1[other1];
+            int e=g2->FindEdge(node2, other2);
+            if (e<0 || !g1->CompatibleEdge(attr1, g2->GetSlotAttr(e)))
+              return false;
+            core1++;
+          }
+        else if (out_1[other1])
+          term1++;
+      }
+
+    // The core neighbours of node1 are mapped on distinct core
+    // neighbours of node2, so it is enough to count the ones
+    // of node2
+    for(i=0; i<deg; i++)
+      { other2=g2->GetOutEdge(node2, i);
+        if (core_2[other2]!=NULL_NODE)
+          core2++;
+        else if (out_2[other2])
+          term2++;
+      }
+
+    return core1==core2 && term1==term2;
+  }
+
+inline void MyVF2StaticState::addPairUndirected(node_id node1, node_id node2)
+  { core_len++;
+    added_node1=node1;
+
+    if (!out_1[node1])
+      { out_1[node1]=core_len;
+        t1out_len++;
+      }
+    if (!out_2[node2])
+      { out_2[node2]=core_len;
+        t2out_len++;
+      }
+
+    core_1[node1]=node2;
+    core_2[node2]=node1;
+
+    int i, other;
+    for(i=0; i<g1->OutEdgeCount(node1); i++)
+      { other=g1->GetOutEdge(node1, i);
+        if (!out_1[other])
+          { out_1[other]=core_len;
+            t1out_len++;
+          }
+      }
+    for(i=0; i<g2->OutEdgeCount(node2); i++)
+      { other=g2->GetOutEdge(node2, i);
+        if (!out_2[other])
+          { out_2[other]=core_len;
+            t2out_len++;
+          }
+      }
+  }
+
+inline void MyVF2StaticState::backTrackUndirected()
+  { if (orig_core_len < core_len)
+      { int i, node2;
+
+        if (out_1[added_node1]==(node_id)core_len)
+          out_1[added_node1]=0;
+        for(i=0; i<g1->OutEdgeCount(added_node1); i++)
+          { int other=g1->GetOutEdge(added_node1, i);
+            if (out_1[other]==(node_id)core_len)
+              out_1[other]=0;
+          }
+
+        node2=core_1[added_node1];
+        if (out_2[node2]==(node_id)core_len)
+          out_2[node2]=0;
+        for(i=0; i<g2->OutEdgeCount(node2); i++)
+          { int other=g2->GetOutEdge(node2, i);
+            if (out_2[other]==(node_id)core_len)
+              out_2[other]=0;
+          }
+
+        core_1[added_node1]=NULL_NODE;
+        core_2[node2]=NULL_NODE;
+
+        core_len=orig_core_len;
+        added_node1=NULL_NODE;
+      }
+  }
+
+
+#endif
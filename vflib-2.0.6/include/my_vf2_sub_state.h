@@ -0,0 +1,506 @@
+/*------------------------------------------------------------
+ * my_vf2_sub_state.h
+ * Interface of my_vf2_sub_state.cc
+ * Definition of a class representing a state of the matching
+ * process for graph-subgraph isomorphism between two ARGs, pruning
+ * the candidate pairs as the VFD algorithm does, by means of
+ * invariants which can be compared by dominance.
+ * See: argraph.h state.h static_state.h reachcount.h
+ *      my_vf2_state.h vf2_sub_state.h
+ *-----------------------------------------------------------------*/
+
+
+
+
+#ifndef MYVF2_SUB_STATE_H
+#define MYVF2_SUB_STATE_H
+
+#include "argraph.h"
+#include "state.h"
+#include "static_state.h"
+#include "reachcount.h"
+
+
+
+/*----------------------------------------------------------
+ * class MyVF2SubStaticState
+ * A representation of the SSR current state, with no
+ * virtual methods; to be used with the template functions
+ * of static_match.h.
+ * See my_vf2_sub_state.cc for more details.
+ ---------------------------------------------------------*/
+class MyVF2SubStaticState
+  { typedef ARGraph_impl Graph;
+
+    private:
+      int core_len, orig_core_len;
+      int added_node1;
+      int t1both_len, t2both_len, t1in_len, t1out_len, 
+          t2in_len, t2out_len; // Core nodes are also counted by these...
+      node_id *core_1;
+      node_id *core_2;
+      node_id *in_1;
+      node_id *in_2;
+      node_id *out_1;
+      node_id *out_2;
+      node_id *order;
+
+      Graph *g1, *g2;
+      int n1, n2;
+
+	  long *share_count;
+
+	  int *reach1, *reach2;
+    
+    public:
+      MyVF2SubStaticState(Graph *g1, Graph *g2, bool sortNodes=false);
+      MyVF2SubStaticState(const MyVF2SubStaticState &state);
+      ~MyVF2SubStaticState(); 
+      Graph *GetGraph1() { return g1; }
+      Graph *GetGraph2() { return g2; }
+      bool NextPair(node_id *pn1, node_id *pn2,
+                    node_id prev_n1=NULL_NODE, node_id prev_n2=NULL_NODE);
+      bool IsFeasiblePair(node_id n1, node_id n2);
+      void AddPair(node_id n1, node_id n2);
+      bool IsGoal() { return core_len==n1 ; };
+      bool IsDead() { return n1>n2  || 
+                         t1both_len>t2both_len ||
+                         t1out_len>t2out_len ||
+                         t1in_len>t2in_len;
+                    };
+      int CoreLen() { return core_len; }
+      void GetCoreSet(node_id c1[], node_id c2[]);
+
+	  void BackTrack();
+  };
+
+
+/*----------------------------------------------------------
+ * class MyVF2SubState
+ * The State interface to MyVF2SubStaticState.
+ ---------------------------------------------------------*/
+class MyVF2SubState: public StateAdapter<MyVF2SubStaticState, MyVF2SubState>
+  { public:
+      MyVF2SubState(Graph *g1, Graph *g2, bool sortNodes=false)
+        : StateAdapter<MyVF2SubStaticState, MyVF2SubState>(g1, g2, sortNodes) {}
+  };
+
+
+/*---------------------------------------------------------------------
+ * INLINE METHODS
+ ---------------------------------------------------------------------*/
+
+/*----------------------------------------------------------
+ * MyVF2SubStaticState::MyVF2SubStaticState(state)
+ * Copy constructor. 
+ ---------------------------------------------------------*/
+inline MyVF2SubStaticState::MyVF2SubStaticState(const MyVF2SubStaticState &state)
+  { g1=state.g1;
+    g2=state.g2;
+    n1=state.n1;
+    n2=state.n2;
+
+    order=state.order;
+
+    core_len=orig_core_len=state.core_len;
+    t1in_len=state.t1in_len;
+    t1out_len=state.t1out_len;
+    t1both_len=state.t1both_len;
+    t2in_len=state.t2in_len;
+    t2out_len=state.t2out_len;
+    t2both_len=state.t2both_len;
+    reach1=state.reach1;
+    reach2=state.reach2;
+    added_node1=NULL_NODE;
+
+    core_1=state.core_1;
+    core_2=state.core_2;
+    in_1=state.in_1;
+    in_2=state.in_2;
+    out_1=state.out_1;
+    out_2=state.out_2;
+    share_count=state.share_count;
+
+	++ *share_count;
+
+  }
+
+
+/*---------------------------------------------------------------
+ * MyVF2SubStaticState::~MyVF2SubStaticState()
+ * Destructor.
+ --------------------------------------------------------------*/
+inline MyVF2SubStaticState::~MyVF2SubStaticState() 
+  { if (-- *share_count == 0)
+    { delete [] core_1;
+      delete [] core_2;
+      delete [] in_1;
+      delete [] out_1;
+      delete [] in_2;
+      delete [] out_2;
+      delete share_count;
+      delete [] reach1;
+      delete [] reach2;
+      delete [] order;
+	}
+  }
+
+
+/*--------------------------------------------------------------------------
+ * bool MyVF2SubStaticState::NextPair(pn1, pn2, prev_n1, prev_n2)
+ * Puts in *pn1, *pn2 the next pair of nodes to be tried.
+ * prev_n1 and prev_n2 must be the last nodes, or NULL_NODE (default)
+ * to start from the first pair.
+ * Returns false if no more pairs are available.
+ -------------------------------------------------------------------------*/
+
+inline bool MyVF2SubStaticState::NextPair(node_id *pn1, node_id *pn2,
+              node_id prev_n1, node_id prev_n2)
+  { 
+    if (prev_n1==NULL_NODE)
+      prev_n1=0;
+
+    if (prev_n2==NULL_NODE)
+      prev_n2=0;
+    else
+      prev_n2++;
+
+	if (t1both_len>core_len && t2both_len>core_len)
+	  { while (prev_n1<(node_id)n1 &&
+           (core_1[prev_n1]!=NULL_NODE || out_1[prev_n1]==0
+		            || in_1[prev_n1]==0))
+          { prev_n1++;    
+            prev_n2=0;
+          }
+	  }
+	else if (t1out_len>core_len && t2out_len>core_len)
+	  { while (prev_n1<(node_id)n1 &&
+           (core_1[prev_n1]!=NULL_NODE || out_1[prev_n1]==0))
+          { prev_n1++;    
+            prev_n2=0;
+          }
+	  }
+    else if (t1in_len>core_len && t2in_len>core_len)
+	  { while (prev_n1<(node_id)n1 &&
+           (core_1[prev_n1]!=NULL_NODE || in_1[prev_n1]==0))
+          { prev_n1++;    
+            prev_n2=0;
+          }
+	  }
+	else if (prev_n1==0 && order!=NULL)
+	  { int i=0;
+	    while (i<n1 && core_1[prev_n1=order[i]]!=NULL_NODE)
+	      i++;
+	    if (i==n1)
+	      prev_n1=n1;
+	  }
+	else
+	  { while (prev_n1<(node_id)n1 && core_1[prev_n1]!=NULL_NODE )
+          { prev_n1++;    
+            prev_n2=0;
+          }
+	  }
+
+    if (prev_n1>=(node_id)n1)
+      return false;
+
+	if (t1both_len>core_len && t2both_len>core_len)
+	  { while (prev_n2<(node_id)n2 &&
+           (core_2[prev_n2]!=NULL_NODE || out_2[prev_n2]==0
+		            || in_2[prev_n2]==0 
+		            || !ReachCountsFit(reach1+prev_n1*REACH_SIZE,
+		                               reach2+prev_n2*REACH_SIZE)))
+          { prev_n2++;    
+          }
+	  }
+	else if (t1out_len>core_len && t2out_len>core_len)
+	  { while (prev_n2<(node_id)n2 &&
+           (core_2[prev_n2]!=NULL_NODE || out_2[prev_n2]==0
+		        || !ReachCountsFit(reach1+prev_n1*REACH_SIZE,
+		                           reach2+prev_n2*REACH_SIZE)))
+          { prev_n2++;    
+          }
+	  }
+    else if (t1in_len>core_len && t2in_len>core_len)
+	  { while (prev_n2<(node_id)n2 &&
+           (core_2[prev_n2]!=NULL_NODE || in_2[prev_n2]==0
+		        || !ReachCountsFit(reach1+prev_n1*REACH_SIZE,
+		                           reach2+prev_n2*REACH_SIZE)))
+          { prev_n2++;    
+          }
+	  }
+	else
+	  { while (prev_n2<(node_id)n2 && (core_2[prev_n2]!=NULL_NODE
+		        || !ReachCountsFit(reach1+prev_n1*REACH_SIZE,
+		                           reach2+prev_n2*REACH_SIZE)))
+          { prev_n2++;    
+          }
+	  }
+	  
+
+    if (prev_n1<(node_id)n1 && prev_n2<(node_id)n2)
+          { *pn1=prev_n1;
+            *pn2=prev_n2;
+            return true;
+          }
+
+    return false;
+  }
+
+/*---------------------------------------------------------------
+ * bool MyVF2SubStaticState::IsFeasiblePair(node1, node2)
+ * Returns true if (node1, node2) can be added to the state
+ * NOTE: 
+ *   The attribute compatibility check (methods CompatibleNode
+ *   and CompatibleEdge of ARGraph) is always performed
+ *   applying the method to g1, and passing the attribute of
+ *   g1 as first argument, and the attribute of g2 as second
+ *   argument. This may be important if the compatibility
+ *   criterion is not symmetric.
+ --------------------------------------------------------------*/
+
+inline bool MyVF2SubStaticState::IsFeasiblePair(node_id node1, node_id node2)
+  { assert(node1<(node_id)n1);
+    assert(node2<(node_id)n2);
+    assert(core_1[node1]==NULL_NODE);
+    assert(core_2[node2]==NULL_NODE);
+
+    if (!g1->CompatibleNode(g1->GetNodeAttr(node1), g2->GetNodeAttr(node2)))
+      return false;
+
+    int i, other1, other2;
+    void *attr1;
+    int termout1out=0, termout2out=0, termin1out=0, termin2out=0, 
+        termout1in=0, termout2in=0, termin1in=0, termin2in=0,
+        new1out=0, new2out=0, new1in=0, new2in=0;
+
+    if (g1->OutEdgeCount(node1)>g2->OutEdgeCount(node2) || 
+        g1->InEdgeCount(node1)>g2->InEdgeCount(node2))
+      return false;
+
+    // Check the 'out' edges of node1
+    for(i=0; i<g1->OutEdgeCount(node1); i++)
+      { other1=g1->GetOutEdge(node1, i, &attr1);
+        if (core_1[other1] != NULL_NODE)
+          { other2=core_1[other1];
+            int e=g2->FindEdge(node2, other2);
+            if (e<0 || !g1->CompatibleEdge(attr1, g2->GetSlotAttr(e)))
+              return false;
+          }
+        else 
+          { if (in_1[other1])
+              termin1out++;
+            if (out_1[other1])
+              termout1out++;
+            if (!in_1[other1] && !out_1[other1])
+              new1out++;
+          }
+      }
+
+    // Check the 'in' edges of node1
+    for(i=0; i<g1->InEdgeCount(node1); i++)
+      { other1=g1->GetInEdge(node1, i, &attr1);
+        if (core_1[other1]!=NULL_NODE)
+          { other2=core_1[other1];
+            int e=g2->FindEdge(other2, node2);
+            if (e<0 || !g1->CompatibleEdge(attr1, g2->GetSlotAttr(e)))
+              return false;
+          }
+        else 
+          { if (in_1[other1])
+              termin1in++;
+            if (out_1[other1])
+              termout1in++;
+            if (!in_1[other1] && !out_1[other1])
+              new1in++;
+          }
+      }
+
+
+    // Check the 'out' edges of node2
+    for(i=0; i<g2->OutEdgeCount(node2); i++)
+      { other2=g2->GetOutEdge(node2, i);
+        if (core_2[other2]!=NULL_NODE)
+          { other1=core_2[other2];
+            if (!g1->HasEdge(node1, other1))
+              return false;
+          }
+        else 
+          { if (in_2[other2])
+              termin2out++;
+            if (out_2[other2])
+              termout2out++;
+            if (!in_2[other2] && !out_2[other2])
+              new2out++;
+          }
+      }
+
+    // Check the 'in' edges of node2
+    for(i=0; i<g2->InEdgeCount(node2); i++)
+      { other2=g2->GetInEdge(node2, i);
+        if (core_2[other2] != NULL_NODE)
+          { other1=core_2[other2];
+            if (!g1->HasEdge(other1, node1))
+              return false;
+          }
+        else 
+          { if (in_2[other2])
+              termin2in++;
+            if (out_2[other2])
+              termout2in++;
+            if (!in_2[other2] && !out_2[other2])
+              new2in++;
+          }
+      }
+
+    return termin1out<=termin2out && termout1out<=termout2out && 
+           termin1in<=termin2in && termout1in<=termout2in &&
+           new1out<=new2out && new1in<=new2in;
+  }
+  
+/*--------------------------------------------------------------
+ * void MyVF2SubStaticState::AddPair(node1, node2)
+ * Adds a pair to the Core set of the state.
+ * Precondition: the pair must be feasible
+ -------------------------------------------------------------*/
+inline void MyVF2SubStaticState::AddPair(node_id node1, node_id node2)
+  { assert(node1<(node_id)n1);
+    assert(node2<(node_id)n2);
+    assert(core_len<n1);
+    assert(core_len<n2);
+
+    core_len++;
+	added_node1=node1;
+
+	if (!in_1[node1])
+	  { in_1[node1]=core_len;
+	    t1in_len++;
+		if (out_1[node1])
+		  t1both_len++;
+	  }
+	if (!out_1[node1])
+	  { out_1[node1]=core_len;
+	    t1out_len++;
+		if (in_1[node1])
+		  t1both_len++;
+	  }
+
+	if (!in_2[node2])
+	  { in_2[node2]=core_len;
+	    t2in_len++;
+		if (out_2[node2])
+		  t2both_len++;
+	  }
+	if (!out_2[node2])
+	  { out_2[node2]=core_len;
+	    t2out_len++;
+		if (in_2[node2])
+		  t2both_len++;
+	  }
+
+    core_1[node1]=node2;
+    core_2[node2]=node1;
+
+
+    int i, other;
+    for(i=0; i<g1->InEdgeCount(node1); i++)
+      { other=g1->GetInEdge(node1, i);
+        if (!in_1[other])
+          { in_1[other]=core_len;
+            t1in_len++;
+		    if (out_1[other])
+		      t1both_len++;
+          }
+      }
+
+    for(i=0; i<g1->OutEdgeCount(node1); i++)
+      { other=g1->GetOutEdge(node1, i);
+        if (!out_1[other])
+          { out_1[other]=core_len;
+            t1out_len++;
+		    if (in_1[other])
+		      t1both_len++;
+          }
+      }
+    
+    for(i=0; i<g2->InEdgeCount(node2); i++)
+      { other=g2->GetInEdge(node2, i);
+        if (!in_2[other])
+          { in_2[other]=core_len;
+            t2in_len++;
+		    if (out_2[other])
+		      t2both_len++;
+          }
+      }
+
+    for(i=0; i<g2->OutEdgeCount(node2); i++)
+      { other=g2->GetOutEdge(node2, i);
+        if (!out_2[other])
+          { out_2[other]=core_len;
+            t2out_len++;
+		    if (in_2[other])
+		      t2both_len++;
+          }
+      }
+
+  }
+
+
+
+/*----------------------------------------------------------------
+ * Undoes the changes to the shared vectors made by the 
+ * current state. Assumes that at most one AddPair has been
+ * performed.
+ ----------------------------------------------------------------*/
+inline void MyVF2SubStaticState::BackTrack()
+  { assert(core_len - orig_core_len <= 1);
+    assert(added_node1 != (int)NULL_NODE);
+  
+    if (orig_core_len < core_len)
+      { int i, node2;
+
+        if (in_1[added_node1] == (node_id)core_len)
+		  in_1[added_node1] = 0;
+	    for(i=0; i<g1->InEdgeCount(added_node1); i++)
+		  { int other=g1->GetInEdge(added_node1, i);
+		    if (in_1[other]==(node_id)core_len)
+			  in_1[other]=0;
+		  }
+        
+		if (out_1[added_node1] == (node_id)core_len)
+		  out_1[added_node1] = 0;
+	    for(i=0; i<g1->OutEdgeCount(added_node1); i++)
+		  { int other=g1->GetOutEdge(added_node1, i);
+		    if (out_1[other]==(node_id)core_len)
+			  out_1[other]=0;
+		  }
+	    
+		node2 = core_1[added_node1];
+
+        if (in_2[node2] == (node_id)core_len)
+		  in_2[node2] = 0;
+	    for(i=0; i<g2->InEdgeCount(node2); i++)
+		  { int other=g2->GetInEdge(node2, i);
+		    if (in_2[other]==(node_id)core_len)
+			  in_2[other]=0;
+		  }
+        
+		if (out_2[node2] == (node_id)core_len)
+		  out_2[node2] = 0;
+	    for(i=0; i<g2->OutEdgeCount(node2); i++)
+		  { int other=g2->GetOutEdge(node2, i);
+		    if (out_2[other]==(node_id)core_len)
+			  out_2[other]=0;
+		  }
+	    
+	    core_1[added_node1] = NULL_NODE;
+		core_2[node2] = NULL_NODE;
+	    
+	    core_len=orig_core_len;
+		added_node1 = NULL_NODE;
+	  }
+
+  }
+
+
+#endif
@@ -0,0 +1,51 @@
+/*------------------------------------------------------------------
+ * parmatch.h
+ * Header of parmatch.cc
+ * Declaration of the parallel version of the match function
+ * See: match.h state.h
+ *-----------------------------------------------------------------*/
+
+
+/*-----------------------------------------------------------------
+ *   DESCRIPTION
+ * parallel_match searches a single matching between two graphs
+ * using several threads. The SSR is divided into tasks, each
+ * identified by the sequence of pairs leading from the initial
+ * state to the root of a subtree. Each thread (worker) keeps
+ * a deque of tasks: it takes its own tasks from the back, and
+ * when its deque is empty it steals the tasks at the front of
+ * the deque of another worker, which are the shallowest ones.
+ * While some worker is idle, a busy worker moves the next
+ * candidate pair of the state it is exploring, at any depth,
+ * into its deque instead of exploring it.
+ *
+ * Since the states of the library share their vectors among
+ * the states of a search path, the workers cannot share the
+ * states: each worker builds its own initial state calling
+ * the factory function, and reaches the root of each task by
+ * adding again the pairs of the task.
+ * A shared flag stops all the workers as soon as one of them
+ * finds a matching.
+ *-----------------------------------------------------------------*/
+
+
+#ifndef PARMATCH_H
+#define PARMATCH_H
+
+#include "argraph.h"
+#include "state.h"
+
+/*------------------------------------------------------------
+ * Definition of the state_factory type
+ * a state factory is a function returning a new initial
+ * state (allocated with new) for the graphs to be matched.
+ * It is called once by each worker, possibly at the same
+ * time by different threads.
+ -----------------------------------------------------------*/
+typedef State *(*state_factory)(void *usr_data);
+
+bool parallel_match(state_factory factory, void *usr_data, int nthreads,
+                    int *pn, node_id c1[], node_id c2[],
+                    long *state_count=NULL);
+
+#endif
@@ -0,0 +1,37 @@
+/*----------------------------------------------------
+ * reachcount.h
+ * Header of reachcount.cc
+ *--------------------------------------------------*/
+
+#ifndef REACHCOUNT_H
+#define REACHCOUNT_H
+
+#include "argraph.h"
+
+/*----------------------------------------------------
+ * REACH_RADIUS is the largest distance considered;
+ * each node has REACH_SIZE counts: the number of nodes
+ * reachable following the 'out' edges within a distance
+ * of 1, 2, ..., REACH_RADIUS, then the same numbers
+ * for the 'in' edges.
+ ---------------------------------------------------*/
+enum { REACH_RADIUS=3, REACH_SIZE=2*REACH_RADIUS };
+
+int* ComputeReachCounts(Graph *g);
+
+/*----------------------------------------------------
+ * Checks if the counts c1 of a pattern node are all
+ * less than or equal to the counts c2 of a target node.
+ * If not, no mapping preserving the edges can associate
+ * the two nodes, since such a mapping cannot increase
+ * the distances.
+ ---------------------------------------------------*/
+inline bool ReachCountsFit(const int *c1, const int *c2)
+  { int i;
+    for(i=0; i<REACH_SIZE; i++)
+      if (c1[i]>c2[i])
+        return false;
+    return true;
+  }
+
+#endif
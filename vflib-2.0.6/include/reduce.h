@@ -0,0 +1,139 @@
+/*------------------------------------------------------------------
+ * reduce.h
+ * Header of treepeel.cc and twins.cc
+ * Definition of the reductions that make a graph smaller
+ * before the search of an isomorphism, moving the structure
+ * of the removed nodes into colours of the remaining ones.
+ * See: argraph.h my_vf2_state.h
+ *-----------------------------------------------------------------*/
+
+
+/*-----------------------------------------------------------------
+ *   DESCRIPTION
+ * A reduction builds from a graph g a smaller graph, the core,
+ * whose nodes have as attribute a colour (a 64 bit hash)
+ * describing the part of g they stand for. Two graphs are
+ * isomorphic if their cores are isomorphic with equal colours
+ * (unless a hash collision has occurred); the matching of the
+ * cores is then expanded to a matching of the whole graphs.
+ * The node and edge attributes of g are not considered.
+ *
+ * TreeReduction removes the tree-like fringes of g: the nodes
+ * with a single neighbour (ignoring the direction of the edges)
+ * are removed, round after round, until none is left. A removed
+ * node hangs from the neighbour it had when it was removed, and
+ * gets a hash of the subtree hanging from it (including the
+ * directions of the edges); a node of the core gets as colour
+ * the hash of the multiset of the subtrees hanging from it.
+ * A component which is a tree is reduced to its centre (one
+ * node, or two adjacent nodes). The subtrees hanging from
+ * paired nodes are paired in linear time, after sorting them
+ * by hash, so equivalent leaves never cause a backtracking.
+ *
+ * TwinReduction collapses the twins: two nodes are false
+ * twins if they are not adjacent and have the same out and in
+ * neighbours, and true twins if they are joined by edges in
+ * both directions and have the same other out and in
+ * neighbours; in both cases they must also have the same self
+ * loops and colours. Twins are interchangeable, and each class
+ * of twins (false twins first, then true twins among the
+ * remaining nodes) is replaced by a single node, whose colour
+ * is a hash of the type of the class, of the number of its
+ * members and of their colour. The collapse is repeated on the
+ * resulting graph until there are no twins left, so nested
+ * blocks (e.g. complete multipartite graphs) are reduced to a
+ * single node. The members of paired classes are paired in
+ * any order.
+ *
+ * tree_match and twin_match reduce both graphs, match the cores
+ * with MyVF2State and expand the matching; the result is checked
+ * against the edges of the graphs, and if a hash collision has
+ * made it wrong the whole graphs are matched instead.
+ *-----------------------------------------------------------------*/
+
+
+#ifndef REDUCE_H
+#define REDUCE_H
+
+#include <vector>
+
+#include "argraph.h"
+
+
+/*----------------------------------------------------------
+ * class ColourComparator
+ * Compares the colours used as node attributes of the cores
+ ---------------------------------------------------------*/
+class ColourComparator: public AttrComparator
+  { public:
+      virtual bool compatible(void *attr1, void *attr2)
+          { return *(unsigned long long*)attr1==
+                   *(unsigned long long*)attr2;
+          }
+  };
+
+
+/*----------------------------------------------------------
+ * class TreeReduction
+ * Removal of the tree-like fringes of a graph
+ ---------------------------------------------------------*/
+class TreeReduction
+  { private:
+      Graph *g;
+      Graph *core;
+      std::vector<node_id> core_node;  // Node of g for each core node
+      std::vector<unsigned long long> colour;  // Colour of each core node
+      std::vector<node_id> parent;     // NULL_NODE for the core nodes
+      std::vector<unsigned long long> item; // Hash of the subtree and
+                                            // of its link to the parent
+      std::vector<int> child_start;    // The nodes hanging from v are
+      std::vector<node_id> child;      // child[child_start[v]] ...
+                                       // sorted by item
+
+    public:
+      TreeReduction(Graph *g);
+      ~TreeReduction();
+      Graph *GetGraph() { return g; }
+      Graph *GetCore() { return core; }
+      int CoreNodeCount() { return core_node.size(); }
+      node_id CoreNode(node_id i) { return core_node[i]; }
+      bool SameColours(TreeReduction *r);
+      int Expand(TreeReduction *r, int n, node_id core1[], node_id core2[],
+                 node_id c1[], node_id c2[]);
+  };
+
+
+/*----------------------------------------------------------
+ * class TwinReduction
+ * Collapse of the classes of twin nodes of a graph
+ ---------------------------------------------------------*/
+class TwinReduction
+  { private:
+      Graph *g;
+      Graph *core;
+      std::vector<int> core_node;     // Class (or node of g) for each
+                                      // core node
+      std::vector<unsigned long long> colour;  // Colour of each core node
+      std::vector<int> member_start;  // The members of the class n+k are
+      std::vector<int> member;        // member[member_start[k]] ...
+                                      // member[member_start[k+1]-1]
+    public:
+      TwinReduction(Graph *g);
+      ~TwinReduction();
+      Graph *GetGraph() { return g; }
+      Graph *GetCore() { return core; }
+      int CoreNodeCount() { return core_node.size(); }
+      int ClassCount() { return member_start.size()-1; }
+      bool SameColours(TwinReduction *r);
+      int Expand(TwinReduction *r, int n, node_id core1[], node_id core2[],
+                 node_id c1[], node_id c2[]);
+  };
+
+
+bool tree_match(Graph *g1, Graph *g2, int *pn, node_id c1[], node_id c2[]);
+bool twin_match(Graph *g1, Graph *g2, int *pn, node_id c1[], node_id c2[]);
+
+bool CheckIsomorphism(Graph *g1, Graph *g2, int n,
+                      node_id c1[], node_id c2[]);
+
+#endif
@@ -8,7 +8,7 @@
  *   to Test Directed Graphs for Isomorphism Using Distance Matrices",
  *   Journal of ACM, Vol. 23, No. 3, pp. 433-445, 1973.
  *
- * See: argraph.h state.h
+ * See: argraph.h state.h static_state.h
  *
  * Author: P. Foggia
  *-----------------------------------------------------------------*/
@@ -20,18 +20,21 @@
 
 #include "argraph.h"
 #include "state.h"
+#include "static_state.h"
 
 
 
 /*----------------------------------------------------------
- * class SDState
- * A representation of the SSR current state
+ * class SDStaticState
+ * A representation of the SSR current state, with no
+ * virtual methods; to be used with the template functions
+ * of static_match.h.
  ---------------------------------------------------------*/
-class SDState: public State
+class SDStaticState
   { typedef ARGraph_impl Graph;
 
     private:
-	  SDState *parent;
+	  SDStaticState *parent;
       int core_len, orig_core_len;
       Graph *g1, *g2;
       int n1, n2;
@@ -46,9 +49,9 @@ class SDState: public State
 	  bool dead_end;
     
     public:
-      SDState(Graph *g1, Graph *g2);
-      SDState(const SDState &state);
-      ~SDState(); 
+      SDStaticState(Graph *g1, Graph *g2);
+      SDStaticState(const SDStaticState &state);
+      ~SDStaticState(); 
       Graph *GetGraph1() { return g1; }
       Graph *GetGraph2() { return g2; }
       bool NextPair(node_id *pn1, node_id *pn2,
@@ -59,11 +62,199 @@ class SDState: public State
       bool IsDead() { return dead_end; };
       int CoreLen() { return core_len; }
       void GetCoreSet(node_id c1[], node_id c2[]);
-      State *Clone();
 
 	  void BackTrack();
   };
 
 
+/*----------------------------------------------------------
+ * class SDState
+ * The State interface to SDStaticState.
+ ---------------------------------------------------------*/
+class SDState: public StateAdapter<SDStaticState, SDState>
+  { public:
+      SDState(Graph *g1, Graph *g2)
+        : StateAdapter<SDStaticState, SDState>(g1, g2) {}
+  };
+
+
+/*---------------------------------------------------------------------
+ * INLINE METHODS
+ ---------------------------------------------------------------------*/
+
+/*-----------------------------------------------------
+ * A copy constructor, which builds a new state as a
+ * child of the current one.
+ ----------------------------------------------------*/
+inline SDStaticState::SDStaticState(const SDStaticState &state)
+  { parent=(SDStaticState *)&state;
+    core_len=orig_core_len=state.core_len;
+	g1=state.g1;
+	g2=state.g2;
+	n1=state.n1;
+	n2=state.n2;
+	dead_end=state.dead_end;
+	share_count=state.share_count;
+	++ *share_count;
+	dist1=state.dist1;
+	dist2=state.dist2;
+	wrk1=state.wrk1;
+	wrk2=state.wrk2;
+	core1=state.core1;
+	core2=state.core2;
+
+	cls1=new node_id[n1];
+	cls2=new node_id[n1];
+	cnt1=new node_id[n1];
+	cnt2=new node_id[n1];
+    int i;
+	for(i=0; i<n1; i++)
+	    cls1[i]=state.cls1[i];
+	for(i=0; i<n1; i++)
+	    cls2[i]=state.cls2[i];
+	for(i=0; i<n1; i++)
+		cnt1[i]=state.cnt1[i];
+	for(i=0; i<n1; i++)
+		cnt2[i]=state.cnt2[i];
+	   
+  }
+
+
+/*------------------------------------------------------------
+ * Destructor. If the state is the topmost one, deallocate
+ * also the shared structures.
+ -----------------------------------------------------------*/
+inline SDStaticState::~SDStaticState()
+  { delete[] cls1;
+    delete[] cls2;
+    delete[] cnt1;
+    delete[] cnt2;
+
+	if (share_count==NULL)
+	  return;
+
+	if (-- *share_count == 0)
+	  { delete[] wrk1;
+	    delete[] wrk2;
+		delete[] core1;
+		delete[] core2;
+		delete share_count;
+		int i;
+		for(i=0; i<n1; i++)
+		  { delete[] dist1[i];
+		    delete[] dist2[i];
+		  }
+		delete[] dist1;
+		delete[] dist2;
+	  }
+
+  }
+
+/*-----------------------------------------------------------------------
+ * Find the next pair of nodes to be checked for addition to the
+ * isomorphism.
+ * Returns false if no other pair can be found.
+ ----------------------------------------------------------------------*/
+inline bool SDStaticState::NextPair(node_id *pn1, node_id *pn2,
+                       node_id prev_n1, node_id prev_n2)
+  { if (prev_n1 == NULL_NODE)
+      { prev_n1 = core_len;
+        prev_n2 = 0;
+      }
+    else if (prev_n2 == NULL_NODE)
+      { prev_n2 = 0;
+      }
+    else
+      { prev_n2 ++;
+      }
+
+    assert(core1[prev_n1]==NULL_NODE);
+
+    while (prev_n2 < (node_id)n2 && 
+          (cls1[prev_n1] != cls2[prev_n2] || core2[prev_n2] != NULL_NODE))
+      prev_n2 ++;
+
+    if (prev_n2 < (node_id)n2)
+      { *pn1 = prev_n1;
+        *pn2 = prev_n2;
+	return true;
+      }
+    else
+      return false;
+  }
+
+
+/*---------------------------------------------------------
+ * Checks if the addition of pair (node1, node2) to the
+ * provisional mapping generates a new consistent
+ * mapping. 
+ * NOTE: For this algorithm this method only checks
+ * semantic attribute compatibility.
+ ---------------------------------------------------------*/
+inline bool SDStaticState::IsFeasiblePair(node_id node1, node_id node2)
+  { if (!g1->CompatibleNode(g1->GetNodeAttr(node1),
+                            g2->GetNodeAttr(node2)))
+      return false;
+    int i;
+    node_id o1, o2;
+    void *attr1, *attr2;
+
+
+    for(i=0; i<g1->OutEdgeCount(node1); i++)
+      { o1=g1->GetOutEdge(node1, i, &attr1);
+        if ((o2=core1[o1]) != NULL_NODE)
+	  { attr2=g2->GetEdgeAttr(node2, o2);
+	    if (!g1->CompatibleEdge(attr1, attr2))
+	      return false;
+	  }
+      }
+
+
+    for(i=0; i<g2->OutEdgeCount(node2); i++)
+      { o2=g2->GetOutEdge(node2, i, &attr2);
+        if ((o1=core2[o2]) != NULL_NODE)
+	  { attr1=g1->GetEdgeAttr(node1, o1);
+	    if (!g1->CompatibleEdge(attr1, attr2))
+	      return false;
+	  }
+      }
+
+
+    for(i=0; i<g1->InEdgeCount(node1); i++)
+      { o1=g1->GetInEdge(node1, i, &attr1);
+        if ((o2=core1[o1]) != NULL_NODE)
+	  { attr2=g2->GetEdgeAttr(o2, node2);
+	    if (!g1->CompatibleEdge(attr1, attr2))
+	      return false;
+	  }
+      }
+
+
+    for(i=0; i<g2->InEdgeCount(node2); i++)
+      { o2=g2->GetInEdge(node2, i, &attr2);
+        if ((o1=core2[o2]) != NULL_NODE)
+	  { attr1=g1->GetEdgeAttr(o1, node1);
+	    if (!g1->CompatibleEdge(attr1, attr2))
+	      return false;
+	  }
+      }
+
+
+    return true;
+  }
+
+/*-----------------------------------------------
+ * Reverts the effect of the last AddPair on
+ * shared data structures
+ ----------------------------------------------*/
+inline void SDStaticState::BackTrack()
+  { if (core_len > orig_core_len)
+      { assert(core_len == orig_core_len+1);
+        core2[core1[orig_core_len]] = NULL_NODE;
+	core1[orig_core_len] = NULL_NODE;
+      }
+  }
+
+
 #endif
 
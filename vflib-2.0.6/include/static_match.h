@@ -0,0 +1,163 @@
+/*------------------------------------------------------------------
+ * static_match.h
+ * Template versions of the match functions, working on
+ * statically polymorphic states.
+ * See: match.h static_state.h
+ *-----------------------------------------------------------------*/
+
+
+/*-----------------------------------------------------------------
+ *   IMPLEMENTATION NOTES
+ * These functions perform the same depth-first search of
+ * match.cc, but the type S of the state is known at compile
+ * time. The methods of S are thus called directly (and can be
+ * inlined), and each child state is a local variable built
+ * with the copy constructor of S instead of a heap object
+ * built by Clone.
+ *
+ * S can be any static state (e.g. VF2StaticState,
+ * SDStaticState, MyVF2StaticState), but also any concrete
+ * subclass of State whose copy constructor builds a child
+ * state. The non-template versions declared in match.h are
+ * chosen only when the static type of the argument is exactly
+ * State*: a pointer to a subclass (e.g. a VF2State* or a
+ * MyVF2State*) selects the template, with S the subclass, and
+ * must be converted to State* to use the virtual methods.
+ *-----------------------------------------------------------------*/
+
+#ifndef STATIC_MATCH_H
+#define STATIC_MATCH_H
+
+#include "argraph.h"
+#include "match.h"
+#include "error.h"
+
+
+template <class S>
+bool static_match(int *pn, node_id c1[], node_id c2[], S *s);
+
+template <class S>
+bool static_match(node_id c1[], node_id c2[], match_visitor vis,
+                  void *usr_data, S *s, int *pcount);
+
+
+/*-------------------------------------------------------------
+ * bool match<S>(s0, pn, c1, c2)
+ * Finds a matching between two graph, if it exists, given the
+ * initial state of the matching process.
+ * Returns true a match has been found.
+ * *pn is assigned the number of matched nodes, and
+ * c1 and c2 will contain the ids of the corresponding nodes
+ * in the two graphs
+ ------------------------------------------------------------*/
+template <class S>
+inline bool match(S *s0, int *pn, node_id c1[], node_id c2[])
+  { return static_match(pn, c1, c2, s0);
+  }
+
+/*------------------------------------------------------------
+ * int match<S>(s0, vis, usr_data)
+ * Visits all the matches between two graphs, given the
+ * initial state of the match.
+ * Returns the number of visited matches.
+ * Stops when there are no more matches, or the visitor vis
+ * returns true.
+ ----------------------------------------------------------*/
+template <class S>
+int match(S *s0, match_visitor vis, void *usr_data=NULL)
+  { Graph *g1=s0->GetGraph1();
+    Graph *g2=s0->GetGraph2();
+
+    /* Choose a conservative dimension for the arrays */
+    int n;
+    if (g1->NodeCount()<g2->NodeCount())
+      n=g2->NodeCount();
+    else
+      n=g1->NodeCount();
+
+    node_id *c1=new node_id[n];
+    node_id *c2=new node_id[n];
+
+    if (!c1 || !c2)
+      error("Out of memory");
+
+    int count=0;
+    static_match(c1, c2, vis, usr_data, s0, &count);
+
+    delete[] c1;
+    delete[] c2;
+    return count;
+  }
+
+
+/*-------------------------------------------------------------
+ * bool static_match<S>(pn, c1, c2, s)
+ * Finds a matching between two graphs, if it exists, starting
+ * from state s.
+ * Returns true a match has been found.
+ * *pn is assigned the numbero of matched nodes, and
+ * c1 and c2 will contain the ids of the corresponding nodes
+ * in the two graphs.
+ ------------------------------------------------------------*/
+template <class S>
+bool static_match(int *pn, node_id c1[], node_id c2[], S *s)
+  { if (s->IsGoal())
+      { *pn=s->CoreLen();
+        s->GetCoreSet(c1, c2);
+        return true;
+      }
+
+    if (s->IsDead())
+      return false;
+
+    node_id n1=NULL_NODE, n2=NULL_NODE;
+    bool found=false;
+    while (!found && s->NextPair(&n1, &n2, n1, n2))
+      { if (s->IsFeasiblePair(n1, n2))
+          { S s1(*s);
+            s1.AddPair(n1, n2);
+            found=static_match(pn, c1, c2, &s1);
+            s1.BackTrack();
+          }
+      }
+    return found;
+  }
+
+
+/*-------------------------------------------------------------
+ * bool static_match<S>(c1, c2, vis, usr_data, s, pcount)
+ * Visits all the matchings between two graphs,  starting
+ * from state s.
+ * Returns true if the caller must stop the visit.
+ * Stops when there are no more matches, or the visitor vis
+ * returns true.
+ ------------------------------------------------------------*/
+template <class S>
+bool static_match(node_id c1[], node_id c2[], match_visitor vis,
+                  void *usr_data, S *s, int *pcount)
+  { if (s->IsGoal())
+      { ++*pcount;
+        int n=s->CoreLen();
+        s->GetCoreSet(c1, c2);
+        return vis(n, c1, c2, usr_data);
+      }
+
+    if (s->IsDead())
+      return false;
+
+    node_id n1=NULL_NODE, n2=NULL_NODE;
+    while (s->NextPair(&n1, &n2, n1, n2))
+      { if (s->IsFeasiblePair(n1, n2))
+          { S s1(*s);
+            s1.AddPair(n1, n2);
+            bool stop=static_match(c1, c2, vis, usr_data, &s1, pcount);
+            s1.BackTrack();
+            if (stop)
+              return true;
+          }
+      }
+    return false;
+  }
+
+
+#endif
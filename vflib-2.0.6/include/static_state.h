@@ -0,0 +1,79 @@
+/*------------------------------------------------------------
+ * static_state.h
+ * Definition of the StateAdapter template, which turns a
+ * statically polymorphic state into an instance of the
+ * abstract class State.
+ * See: state.h static_match.h
+ *-----------------------------------------------------------------*/
+
+
+/*-----------------------------------------------------------------
+ *   DESCRIPTION
+ * A static state is a class with the same methods of State
+ * (except Clone), none of which is virtual. The copy
+ * constructor of a static state plays the role of Clone: it
+ * must build a child of the state passed as argument, exactly
+ * as State::Clone does for the virtual interface.
+ *
+ * The template functions in static_match.h take the type of
+ * the state as a template parameter, so that the calls to
+ * NextPair, IsFeasiblePair, AddPair etc. in the inner loop of
+ * the search are resolved at compile time and can be inlined,
+ * and the child states live on the stack instead of being
+ * allocated with new.
+ *
+ * StateAdapter<S, Derived> provides the virtual interface for
+ * a static state S, so that the same implementation can be
+ * used with the non-template match() functions, or wherever
+ * a State* is required. Derived is the adapter class itself
+ * (the CRTP idiom), needed by Clone to allocate an object of
+ * the right type.
+ *-----------------------------------------------------------------*/
+
+#ifndef STATIC_STATE_H
+#define STATIC_STATE_H
+
+#include "argraph.h"
+#include "state.h"
+
+
+/*----------------------------------------------------------
+ * class StateAdapter
+ * Implements the State interface by forwarding each
+ * method to a static state of type S.
+ ---------------------------------------------------------*/
+template <class S, class Derived>
+class StateAdapter: public State
+  { protected:
+      S s;
+
+    public:
+      typedef S static_state_type;
+
+      template <class A1, class A2>
+      StateAdapter(A1 a1, A2 a2) : s(a1, a2) {}
+      template <class A1, class A2, class A3>
+      StateAdapter(A1 a1, A2 a2, A3 a3) : s(a1, a2, a3) {}
+      StateAdapter(const StateAdapter &state) : State(), s(state.s) {}
+
+      S *GetStaticState() { return &s; }
+
+      Graph *GetGraph1() { return s.GetGraph1(); }
+      Graph *GetGraph2() { return s.GetGraph2(); }
+      bool NextPair(node_id *pn1, node_id *pn2,
+                    node_id prev_n1=NULL_NODE, node_id prev_n2=NULL_NODE)
+          { return s.NextPair(pn1, pn2, prev_n1, prev_n2); }
+      bool IsFeasiblePair(node_id n1, node_id n2)
+          { return s.IsFeasiblePair(n1, n2); }
+      void AddPair(node_id n1, node_id n2) { s.AddPair(n1, n2); }
+      bool IsGoal() { return s.IsGoal(); }
+      bool IsDead() { return s.IsDead(); }
+      int CoreLen() { return s.CoreLen(); }
+      void GetCoreSet(node_id c1[], node_id c2[]) { s.GetCoreSet(c1, c2); }
+      State *Clone() { return new Derived(*static_cast<Derived*>(this)); }
+
+      void BackTrack() { s.BackTrack(); }
+  };
+
+
+#endif
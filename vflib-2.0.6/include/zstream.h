@@ -0,0 +1,118 @@
+/*------------------------------------------------------------------
+ * zstream.h
+ * Header of zstream.cc
+ * Definition of an input stream which decompresses the gzip or
+ * zstd data read from another stream, for the graph loaders.
+ * See: argloader.h csrgraph.h
+ *-----------------------------------------------------------------*/
+
+
+/*-----------------------------------------------------------------
+ *   DESCRIPTION
+ * A DecompressStream reads from another istream, and recognizes
+ * the format of the data from their first bytes (the magic
+ * numbers of gzip and of zstd); the compressed data are
+ * decompressed while they are read, and any other data are passed
+ * unchanged. So a loader reading from a DecompressStream accepts
+ * both compressed and plain files, without temporary files:
+ *
+ *     ifstream f("iso_r001_m200.A00.gz", ios::in | ios::binary);
+ *     DecompressStream in(f);
+ *     BinaryGraphLoader loader(in);
+ *     Graph g(&loader);
+ *
+ * The same holds for StreamARGLoader; ConvertBinaryGraph (see
+ * csrgraph.h) uses a DecompressStream too.
+ *
+ * The compressed data are decompressed in blocks by a separate
+ * thread, which fills the next blocks while the previous one is
+ * parsed. The source stream must not be used while the
+ * DecompressStream exists.
+ *
+ * gzip is supported if the library is compiled with HAVE_ZLIB
+ * defined (the programs must then be linked with -lz), and zstd
+ * if it is compiled with HAVE_ZSTD (-lzstd); a compressed input
+ * in a format which is not supported, or corrupted, or truncated,
+ * is reported with error().
+ *
+ * The stream can be moved back (with seekg) only within the block
+ * being read, which is enough for StreamARGLoader to leave the
+ * stream after the end of a graph in most cases.
+ *-----------------------------------------------------------------*/
+
+
+#ifndef ZSTREAM_H
+#define ZSTREAM_H
+
+#include <iostream>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+
+/*----------------------------------------------------------
+ * class DecompressBuf
+ * The stream buffer of a DecompressStream
+ ---------------------------------------------------------*/
+class DecompressBuf: public streambuf
+  { public:
+      enum { PLAIN_INPUT, GZIP_INPUT, ZSTD_INPUT };
+
+      DecompressBuf(istream &src);
+      ~DecompressBuf();
+      int Format() { return format; }
+
+    protected:
+      virtual int_type underflow();
+      virtual pos_type seekoff(off_type off, ios_base::seekdir dir,
+                               ios_base::openmode which);
+      virtual pos_type seekpos(pos_type pos, ios_base::openmode which);
+
+    private:
+      enum { BLOCK_SIZE=262144, BLOCKS=3 };
+      istream &src;
+      int format;
+      char magic[4];           // First bytes of src, not yet used
+      int magic_len, magic_pos;
+      long long base;          // Position in the stream of eback()
+
+      // The blocks are passed from the producer thread to the
+      // reader through the queue ready, and back through free_blocks
+      std::vector<char> block[BLOCKS];
+      size_t block_len[BLOCKS];
+      std::deque<int> ready, free_blocks;
+      int current;             // Block in the get area, or -1
+      bool done, stop;
+      const char *failure;     // Error of the producer, or NULL
+      std::mutex mtx;
+      std::condition_variable cond;
+      std::thread producer;
+
+      size_t readInput(char *buf, size_t len);
+      int takeFree();
+      void putReady(int k, size_t len);
+      void finish(const char *failure);
+      void produce();
+      const char *inflateGzip();
+      const char *decompressZstd();
+  };
+
+
+/*----------------------------------------------------------
+ * class DecompressStream
+ * An istream over a DecompressBuf
+ ---------------------------------------------------------*/
+class DecompressStream: public istream
+  { private:
+      DecompressBuf buf;
+    public:
+      DecompressStream(istream &src): istream(NULL), buf(src)
+          { init(&buf); }
+      int Format() { return buf.Format(); }
+  };
+
+#endif
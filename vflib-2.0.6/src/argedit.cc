@@ -19,6 +19,8 @@
  *
  ----------------------------------------------------------*/
 
+#include <algorithm>
+
 #include "argedit.h"
 #include "error.h"
 
@@ -27,9 +29,6 @@
  ---------------------------------------------------------*/
 ARGEdit:: ARGEdit() 
   { count=0;
-    nodes=NULL;
-    lastNode=NULL;
-    lastEdge=NULL;
   }
 
 /*----------------------------------------------------------
@@ -37,16 +36,15 @@ ARGEdit:: ARGEdit()
  ---------------------------------------------------------*/
 ARGEdit:: ARGEdit(ARGraph_impl &g) 
   { count=0;
-    nodes=NULL;
-    lastNode=NULL;
-    lastEdge=NULL;
 
     node_id n;
-    for(n=0; n<g.NodeCount(); n++)
+    nodes.reserve(g.NodeCount());
+    for(n=0; n<(node_id)g.NodeCount(); n++)
       InsertNode(g.GetNodeAttr(n));
     int i;
-    for(n=0; n<g.NodeCount(); n++)
-      { for(i=0; i<g.OutEdgeCount(n); i++)
+    for(n=0; n<(node_id)g.NodeCount(); n++)
+      { nodes[n].edges.reserve(g.OutEdgeCount(n));
+        for(i=0; i<g.OutEdgeCount(n); i++)
           { void *attr; 
             node_id n2=g.GetOutEdge(n, i, &attr);
             InsertEdge(n, n2, attr);
@@ -59,16 +57,15 @@ ARGEdit:: ARGEdit(ARGraph_impl &g)
  ---------------------------------------------------------*/
 ARGEdit:: ARGEdit(ARGLoader &g) 
   { count=0;
-    nodes=NULL;
-    lastNode=NULL;
-    lastEdge=NULL;
 
     node_id n;
-    for(n=0; n<g.NodeCount(); n++)
+    nodes.reserve(g.NodeCount());
+    for(n=0; n<(node_id)g.NodeCount(); n++)
       InsertNode(g.GetNodeAttr(n));
     int i;
-    for(n=0; n<g.NodeCount(); n++)
-      { for(i=0; i<g.OutEdgeCount(n); i++)
+    for(n=0; n<(node_id)g.NodeCount(); n++)
+      { nodes[n].edges.reserve(g.OutEdgeCount(n));
+        for(i=0; i<g.OutEdgeCount(n); i++)
           { void *attr; 
             node_id n2=g.GetOutEdge(n, i, &attr);
             InsertEdge(n, n2, attr);
@@ -81,22 +78,12 @@ ARGEdit:: ARGEdit(ARGLoader &g)
  * Destructor
  ---------------------------------------------------------*/
 ARGEdit::~ARGEdit()
-  { nNode *pn, *pn1;
-    eNode *pe, *pe1;
-
-    pn=nodes;
-    while (pn!=NULL)
-      { pe=pn->edges;
-        while (pe!=NULL)
-          { pe1=pe;
-            pe=pe->next;
-            destroyEdgeAttr(pe1->attr);
-            delete pe1;
-          }
-        pn1=pn;
-        pn=pn->next;
-        destroyNodeAttr(pn1->attr);
-        delete pn1;
+  { int i, k;
+
+    for(i=0; i<count; i++)
+      { for(k=0; k<(int)nodes[i].edges.size(); k++)
+          destroyEdgeAttr(nodes[i].edges[k].attr);
+        destroyNodeAttr(nodes[i].attr);
       }
   }
 
@@ -112,32 +99,18 @@ int ARGEdit::NodeCount()
  * Returns the attr of a node.
  ----------------------------------------------------*/
 void* ARGEdit::GetNodeAttr(node_id id)
-  { nNode *n=nodes;
-
-    if (lastNode!=NULL && lastNode->id <= id)
-      n=lastNode;
-    
-    while (n!=NULL && n->id!=id)
-      n=n->next;
-    if (n==NULL)
+  { if (id>=(node_id)count)
       error("Inconsistent data");
-    return n->attr;
+    return nodes[id].attr;
   }
 
 /*------------------------------------------------------
  * Returns the number of edges coming out of a node.
  ----------------------------------------------------*/
 int ARGEdit::OutEdgeCount(node_id id)
-  { nNode *n=nodes;
-
-    if (lastNode!=NULL && lastNode->id <= id)
-      n=lastNode;
-    
-    while (n!=NULL && n->id!=id)
-      n=n->next;
-    if (n==NULL)
+  { if (id>=(node_id)count)
       error("Inconsistent data");
-    return n->count;
+    return nodes[id].edges.size();
   }
 
 /*------------------------------------------------------
@@ -145,40 +118,16 @@ int ARGEdit::OutEdgeCount(node_id id)
  ----------------------------------------------------*/
 node_id ARGEdit::
 GetOutEdge(node_id id, int i, void **pattr)
-  { nNode *n=nodes;
-
-    if (lastNode!=NULL && lastNode->id <= id)
-      n=lastNode;
-    
-    while (n!=NULL && n->id!=id)
-      n=n->next;
-    if (n==NULL)
+  { if (id>=(node_id)count)
       error("Inconsistent data");
-
-    eNode *e=n->edges;
-    int pos=0;
-
-    if (lastEdge!=NULL && lastEdge->from==id && 
-        lastEdge->pos>=0 && lastEdge->pos<=i)
-      { e=lastEdge;
-        pos=e->pos;
-      }
-
-    while (e!=NULL && pos<i)
-      { e->pos=pos;
-        e=e->next;
-        pos++;
-      }
-
-    if (e==NULL)
+    nNode &n=sortedNode(id);
+    if (i<0 || i>=(int)n.edges.size())
       error("Inconsistent data");
 
+    eNode &e=n.edges[i];
     if (pattr!=NULL)
-      *pattr = e->attr;
-    lastNode = n;
-    lastEdge = e;
-
-    return e->to;
+      *pattr = e.attr;
+    return e.to;
   }
 
 
@@ -188,36 +137,11 @@ GetOutEdge(node_id id, int i, void **pattr)
  * Creates a new node
  ------------------------------------------*/
 node_id ARGEdit::InsertNode(void* attr)
-  { nNode *n=new nNode;
-    if (n==NULL)
-      error("Out of memory");
-    node_id id=n->id=count++;
-    n->attr=attr;
-    n->edges=NULL;
-    n->count=0;
-
-    nNode *p=nodes, *p0=NULL;
-    if (lastNode!=NULL && lastNode->id<id)
-      { p0=lastNode;
-        p=lastNode->next;
-      }
-    while(p!=NULL && p->id<id) 
-      { p0=p; 
-        p=p->next;
-      }
-
-
-    if (p0==NULL)
-      { n->next=nodes;
-        nodes=n;
-      }
-    else
-      { n->next=p0->next;
-        p0->next=n;
-      }
-    lastNode=n;
-
-     return n->id;
+  { nodes.resize(count+1);
+    nNode &n=nodes[count];
+    n.attr=attr;
+    n.sorted=true;
+    return count++;
   }
 
 
@@ -226,48 +150,22 @@ node_id ARGEdit::InsertNode(void* attr)
  * Creates a new edge
  ------------------------------------------*/
 void ARGEdit::InsertEdge(node_id id1, node_id id2, void* attr)
-  {
-    eNode *e=new eNode;
-    if (e==NULL)
-      error("Out of memory");
-    e->from=id1;
-    e->to=id2;
-    e->attr=attr;
-    e->pos=-1;
-    nNode *pn=nodes;
-    if (lastNode!=NULL && lastNode->id<=id1)
-      { pn=lastNode;
-      }
-    while(pn!=NULL && pn->id<id1) 
-      { pn=pn->next;
-      }
-    if (pn==NULL || pn->id!=id1)
+  { if (id1>=(node_id)count)
       error("Bad param 1 in ARGEdit::InsertEdge: %d", (int)id1);
 
-    eNode *p=pn->edges, *p0=NULL;
-    if (lastEdge!=NULL && lastEdge->from==id1 && lastEdge->to<id2)
-      { p0=lastEdge;
-        p=lastEdge->next;
-      }
-    while (p!=NULL && p->to<id2)
-      { p0=p;
-        p=p->next;
-      }
-    if (p!=NULL && p->to==id2)
-      error("Bad param 2 in ARGEdit::InsertEdge: %d", (int)id2);
-
-    if (p0==NULL)
-      { e->next=pn->edges;
-        pn->edges=e;
-      }
-    else
-      { e->next=p0->next;
-        p0->next=e;
-      }
-    pn->count++;
-    lastNode=pn;
-    lastEdge=e;
-}
+    nNode &n=nodes[id1];
+    if (!n.edges.empty() && n.sorted)
+      { node_id last=n.edges.back().to;
+        if (last==id2)
+          error("Bad param 2 in ARGEdit::InsertEdge: %d", (int)id2);
+        if (last>id2)
+          n.sorted=false;
+      }
+    eNode e;
+    e.to=id2;
+    e.attr=attr;
+    n.edges.push_back(e);
+  }
 
 
 
@@ -275,110 +173,67 @@ void ARGEdit::InsertEdge(node_id id1, node_id id2, void* attr)
  * Delete a node
  --------------------------------------------------*/
 void ARGEdit::DeleteNode(node_id id)
-  { nNode *p=nodes, *p0=NULL;
-
-    if (lastNode!=NULL && lastNode->id<id)
-      { p0=lastNode;
-        p=lastNode->next;
-      }
-    while(p!=NULL && p->id<id) 
-      { p0=p; 
-        p=p->next;
-      }
+  { int i, j, k;
 
-    if (p==NULL || !p->id==id)
+    if (id>=(node_id)count)
       error("Bad param in ARGEdit::DeleteNode");
 
-    while (p->edges != NULL)
-      { eNode *ep=p->edges;
-        p->edges=ep->next;
-        destroyEdgeAttr(ep->attr);
-        delete ep;
-      }
-    lastEdge=NULL;
-    destroyNodeAttr(p->attr);
-    if (p0==NULL)
-      { nodes=p->next;
-      }
-    else
-      { p0->next=p->next;
-      }
-    delete p;
+    nNode &p=sortedNode(id);
+    for(k=0; k<(int)p.edges.size(); k++)
+      destroyEdgeAttr(p.edges[k].attr);
+    destroyNodeAttr(p.attr);
+    nodes.erase(nodes.begin()+id);
     count--;
 
-    p=nodes;
-    while (p!=NULL)
-      { if (p->id > id)
-          p->id --;
-        eNode *ep0=NULL;
-        eNode *ep=p->edges;
-        while (ep!=NULL)
-          { if (ep->to == id)
-              { if (ep0==NULL)
-                  p->edges=ep->next;
-                else
-                  ep0->next=ep->next;
-                destroyEdgeAttr(ep->attr);
-                delete ep;
-		p->count--;
-                if (ep0==NULL)
-                  ep=p->edges;
-                else
-                  ep=ep0->next;
+    for(i=0; i<count; i++)
+      { std::vector<eNode> &ed=nodes[i].edges;
+        for(j=k=0; j<(int)ed.size(); j++)
+          { if (ed[j].to == id)
+              { destroyEdgeAttr(ed[j].attr);
                 continue;
               }
-            if (ep->from > id)
-              ep->from --;
-            if (ep->to > id)
-              ep->to --;
-            ep0=ep;
-            ep=ep->next;
+            if (ed[j].to > id)
+              ed[j].to --;
+            ed[k++]=ed[j];
           }
-        p=p->next;
+        ed.resize(k);
       }
-    
-
-    lastNode=p0;
   }
 
 /*------------------------------------
  * Delete an edge
  -----------------------------------*/
 void ARGEdit::DeleteEdge(node_id id1, node_id id2)
-  { nNode *pn=nodes;
-
-    if (lastNode!=NULL && lastNode->id<=id1)
-      pn=lastNode;
-
-    while (pn!=NULL && pn->id < id1)
-      pn=pn->next;
-
-    if (pn==NULL || pn->id != id1)
+  { if (id1>=(node_id)count)
       error("Bad param in ARGEdit::DeleteEdge");
 
-    eNode *pe=pn->edges, *pe0=NULL;
-
-    if (lastEdge!=NULL &&  lastEdge->from==id1 && lastEdge->to < id2)
-      { pe0=lastEdge;
-        pe=pe0->next;
-      }
-
-    while (pe!=NULL && pe->to<id2)
-      { pe0=pe;
-        pe=pe->next;
-      }
-    
-    if (pe==NULL || pe->to != id2)
+    std::vector<eNode> &ed=sortedNode(id1).edges;
+    eNode key;
+    key.to=id2;
+    std::vector<eNode>::iterator pe=std::lower_bound(ed.begin(), ed.end(),
+                                                     key);
+    if (pe==ed.end() || pe->to != id2)
       error("Bad param in ARGEdit::DeleteEdge");
 
-    if (pe0==NULL)
-      pn->edges=pe->next;
-    else
-      pe0->next=pe->next;
     destroyEdgeAttr(pe->attr);
-    delete pe;
-    pn->count--;
+    ed.erase(pe);
+  }
+
 
-    lastNode=pn;
-    lastEdge=pe0;
+/*------------------------------------------------------
+ * Returns a node, sorting its edges if they were
+ * inserted out of order
+ ----------------------------------------------------*/
+ARGEdit::nNode &ARGEdit::sortedNode(node_id id)
+  { nNode &n=nodes[id];
+    if (!n.sorted)
+      { std::stable_sort(n.edges.begin(), n.edges.end());
+        int k;
+        for(k=1; k<(int)n.edges.size(); k++)
+          if (n.edges[k].to==n.edges[k-1].to)
+            error("Bad param 2 in ARGEdit::InsertEdge: %d",
+                  (int)n.edges[k].to);
+        n.sorted=true;
+      }
+    return n;
   }
@@ -59,63 +59,274 @@
  *     02 00     Target of the second edge of node 1 (edge 1 -> 2)
  *     01 00     Number of edges out of node 2 (1)
  *     00 00     Target of the first (and only) edge of node 2 (edge 2 -> 0)
+ * The constructor and write() have a parameter word_size, which can
+ * be 4 to use 32-bit words instead (for graphs with more than
+ * 65535 nodes, or nodes with more than 65535 edges; the graph
+ * must also fit in node_id, see VF_NODE_ID_32 in argraph.h).
  -----------------------------------------------------------------------------*/
 
 
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+
 #include "argloader.h"
+#include "error.h"
 
 
 
 /*------------------------------------------------------------------
- * Create a BinaryGraphLoader reading from a binary istream.
+ * Create a BinaryGraphLoader reading from a binary istream,
+ * made of words of word_size bytes (2 or 4).
+ * The words of each node are read with a single read() and
+ * decoded from a buffer, and the edges are stored directly in
+ * the vectors returned to the graph, sorted. It is an error if
+ * the file ends before the graph, or if an edge is out of range
+ * or repeated.
  * NOTE: the input stream must be open with the 
  * ios::binary | ios::in mode.
  -----------------------------------------------------------------*/
-BinaryGraphLoader::BinaryGraphLoader(istream &in)
-  { unsigned n, ne, dest;
-    unsigned i,j;
+BinaryGraphLoader::BinaryGraphLoader(istream &in, int word_size)
+  { unsigned n, ne;
+    unsigned i, j;
+    std::vector<unsigned char> buf;
+    std::vector<unsigned> w;
 
-    n = readWord(in);
-    for(i=0; i<n; i++)
-      InsertNode(NULL);
+    if (word_size!=2 && word_size!=4)
+      error("BinaryGraphLoader: bad word size %d", word_size);
+    readWords(in, word_size, buf, w, 1);
+    n = w[0];
+    if (n>NULL_NODE)
+      error("BinaryGraphLoader: too many nodes for node_id: %u", n);
+    out_start.resize(n+1);
+    out_start[0]=0;
     for(i=0; i<n; i++)
-      { ne = readWord(in);
+      { readWords(in, word_size, buf, w, 1);
+        ne = w[0];
+        if (ne>n)
+          error("BinaryGraphLoader: too many edges for node %u: %u", i, ne);
+        readWords(in, word_size, buf, w, ne);
+        bool sorted=true;
         for(j=0; j<ne; j++)
-	  { dest=readWord(in);
-	    InsertEdge(i, dest, NULL);
-	  }
-       }
-   }
+          { if (w[j]>=n)
+              error("BinaryGraphLoader: bad edge %u -> %u", i, w[j]);
+            if (j>0 && w[j]<=w[j-1])
+              sorted=false;
+          }
+        if (!sorted)
+          { std::sort(w.begin(), w.begin()+ne);
+            for(j=1; j<ne; j++)
+              if (w[j]==w[j-1])
+                error("BinaryGraphLoader: repeated edge %u -> %u", i, w[j]);
+          }
+        out_node.insert(out_node.end(), w.begin(), w.begin()+ne);
+        out_start[i+1]=out_node.size();
+      }
+  }
 
  /*--------------------------------------------------------------
-  * Save a graph on a file readable by a BinaryGraphLoader.
+  * Save a graph on a file readable by a BinaryGraphLoader
+  * with the same word_size.
   * NOTE: the output stream must be open with the 
   * ios::binary | ios::out mode.
   -------------------------------------------------------------*/
-void BinaryGraphLoader::write(ostream& out, Graph &g)
+void BinaryGraphLoader::write(ostream& out, Graph &g, int word_size)
   { int i,j;
-    writeWord(out, g.NodeCount());
+    if (word_size!=2 && word_size!=4)
+      error("BinaryGraphLoader: bad word size %d", word_size);
+    writeWord(out, g.NodeCount(), word_size);
     for(i=0; i<g.NodeCount(); i++)
-      { writeWord(out, g.OutEdgeCount(i));
+      { writeWord(out, g.OutEdgeCount(i), word_size);
         for(j=0; j<g.OutEdgeCount(i); j++)
-	  writeWord(out, g.GetOutEdge(i,j,NULL));
+	  writeWord(out, g.GetOutEdge(i,j), word_size);
       }
   }
 
  /*-----------------------------------------------------------------
   * Private functions
   ----------------------------------------------------------------*/
-unsigned BinaryGraphLoader::readWord(istream& in)
-  { unsigned char c1, c2;
-    c1=(char)in.get(); // Yes, I know this way I discard EOF...
-    c2=(char)in.get();
-    return c1 | (c2 << 8);
+
+/*----------------------------------------------------------
+ * Reads count words into words, through the byte buffer buf
+ ---------------------------------------------------------*/
+void BinaryGraphLoader::readWords(istream& in, int word_size,
+                                  std::vector<unsigned char> &buf,
+                                  std::vector<unsigned> &words,
+                                  unsigned count)
+  { size_t len=(size_t)count*word_size;
+    unsigned i;
+    if (count==0)
+      return;
+    if (buf.size()<len)
+      buf.resize(len);
+    if (words.size()<count)
+      words.resize(count);
+    in.read((char*)&buf[0], len);
+    if ((size_t)in.gcount()!=len)
+      error("BinaryGraphLoader: unexpected end of file");
+    const unsigned char *p=&buf[0];
+    if (word_size==2)
+      for(i=0; i<count; i++, p+=2)
+        words[i]=p[0] | (unsigned)p[1]<<8;
+    else
+      for(i=0; i<count; i++, p+=4)
+        words[i]=p[0] | (unsigned)p[1]<<8 | (unsigned)p[2]<<16 |
+                 (unsigned)p[3]<<24;
+  }
+
+void BinaryGraphLoader::writeWord(ostream& out, unsigned w, int word_size)
+  { int i;
+    if (word_size<4 && (w>>(8*word_size))!=0)
+      error("BinaryGraphLoader: value %u does not fit in a word", w);
+    for(i=0; i<word_size; i++)
+      { unsigned char c = (w >> (8*i)) & 0xFF;
+        out << c;
+      }
+  }
+
+
+
+/*------------------------------------------------------------
+ * Methods of the class ARGLineReader
+ -----------------------------------------------------------*/
+
+/*----------------------------------------------------------
+ * Constructor
+ ---------------------------------------------------------*/
+ARGLineReader::ARGLineReader(istream &in): in(in)
+  { pos=len=0;
+    line_no=0;
+    eof=false;
+  }
+
+/*----------------------------------------------------------
+ * Returns the next line which is not blank and does not
+ * begin with #, terminated by '\0'; the line is valid until
+ * the next call. It is an error if the file ends.
+ ---------------------------------------------------------*/
+char *ARGLineReader::NextLine()
+  { char *line, *p;
+    do {
+      line=readLine();
+      if (line==NULL)
+        error("End of file or reading error at line %d", line_no);
+      for(p=line; isspace((unsigned char)*p); p++)
+        ;
+    } while (*p=='\0' || *p=='#');
+    return line;
+  }
+
+/*----------------------------------------------------------
+ * Moves the stream back to the first byte not used (if the
+ * stream allows it), and clears its end of file state.
+ ---------------------------------------------------------*/
+void ARGLineReader::Finish()
+  { in.clear();
+    if (len>pos)
+      { in.seekg(-(streamoff)(len-pos), ios::cur);
+        in.clear();
+      }
+    pos=len=0;
+  }
+
+/*----------------------------------------------------------
+ * Returns the next line, terminated by '\0', or NULL at the
+ * end of the file. A block is read when the buffer does not
+ * contain a whole line.
+ ---------------------------------------------------------*/
+char *ARGLineReader::readLine()
+  { for(;;)
+      { char *nl=NULL;
+        if (len>pos)
+          nl=(char*)memchr(&buf[pos], '\n', len-pos);
+        if (nl!=NULL || (eof && len>pos))
+          { char *line=&buf[pos];
+            if (nl==NULL)
+              nl=&buf[len];   // Last line, without '\n'
+            *nl='\0';
+            pos=nl-&buf[0]+1;
+            if (pos>len)
+              pos=len;
+            line_no++;
+            return line;
+          }
+        if (eof)
+          return NULL;
+
+        // Keep the incomplete line, and read a block after it
+        if (pos>0)
+          { memmove(&buf[0], &buf[pos], len-pos);
+            len-=pos;
+            pos=0;
+          }
+        if (buf.size()<len+BLOCK_SIZE+1)
+          buf.resize(len+BLOCK_SIZE+1);
+        in.read(&buf[len], BLOCK_SIZE);
+        size_t got=in.gcount();
+        len+=got;
+        if (got<BLOCK_SIZE)
+          eof=true;
+      }
   }
 
-void BinaryGraphLoader::writeWord(ostream& out, unsigned w)
-  { unsigned char c1, c2;
 
-    c1 = w & 0xFF; 
-    c2 = w >> 8;
-    out << c1 << c2;
+/*------------------------------------------------------------
+ * Parsing of numbers
+ -----------------------------------------------------------*/
+
+/*----------------------------------------------------------
+ * Parses a decimal integer, with an optional sign
+ ---------------------------------------------------------*/
+bool parse_integer(const char **ptext, long long *v)
+  { const char *p=*ptext;
+    while (isspace((unsigned char)*p))
+      p++;
+    bool neg=false;
+    if (*p=='-' || *p=='+')
+      neg=(*p++=='-');
+    const char *q=p;
+    unsigned long long u;
+    if (*p<'0' || *p>'9' || !parse_unsigned(&q, &u))
+      return false;
+    if (u>(unsigned long long)std::numeric_limits<long long>::max()+neg)
+      return false;
+    *v=neg? (long long)(0-u): (long long)u;
+    *ptext=q;
+    return true;
+  }
+
+/*----------------------------------------------------------
+ * Parses a decimal integer without sign
+ ---------------------------------------------------------*/
+bool parse_unsigned(const char **ptext, unsigned long long *v)
+  { const char *p=*ptext;
+    while (isspace((unsigned char)*p))
+      p++;
+    if (*p=='+')
+      p++;
+    if (*p<'0' || *p>'9')
+      return false;
+    unsigned long long u=0;
+    for( ; *p>='0' && *p<='9'; p++)
+      { unsigned d=*p-'0';
+        if (u>(std::numeric_limits<unsigned long long>::max()-d)/10)
+          return false;
+        u=u*10+d;
+      }
+    *v=u;
+    *ptext=p;
+    return true;
+  }
+
+/*----------------------------------------------------------
+ * Parses a floating point number, in the format of strtod
+ ---------------------------------------------------------*/
+bool parse_real(const char **ptext, double *v)
+  { char *end;
+    double d=strtod(*ptext, &end);
+    if (end==*ptext)
+      return false;
+    *v=d;
+    *ptext=end;
+    return true;
   }
@@ -43,6 +43,15 @@ inline void clear(byte *ptr, int n)
  --------------------------------------------------------------*/
 static void ptrcheck(void *);
 
+/*---------------------------------------------------------------
+ * Hash function of the node ids, for the hash tables of the
+ * edges (Fibonacci hashing, folded on the low bits)
+ --------------------------------------------------------------*/
+static inline unsigned hash_node(node_id id)
+  { unsigned h=(unsigned)id*2654435761U;
+    return h^(h>>16);
+  }
+
 /*----------------------------------------------------------------
  * methods of the class ARGraph_impl
  ---------------------------------------------------------------*/
@@ -55,58 +64,127 @@ ARGraph_impl::ARGraph_impl(ARGLoader *loader)
     edge_destroyer=NULL;
     node_comparator=NULL;
     edge_comparator=NULL;
+    shared_edges=false;
     n = loader->NodeCount();
-    attr = new void*[n];
-    ptrcheck(attr);
-    int i, j;
-    for(i=0; i<n; i++)
-      attr[i]=loader->GetNodeAttr(i);
-    in_count=new count_type[n];
-    ptrcheck(in_count);
-    clear(in_count, n);
-    out_count=new count_type[n];
-    ptrcheck(out_count);
-    clear(out_count, n);
-    in=new node_id*[n];
-    ptrcheck(in);
-    clear(in, n);
-    out=new node_id*[n];
-    ptrcheck(out);
-    clear(out, n);
-    in_attr=new void**[n];
-    ptrcheck(in_attr);
-    clear(in_attr, n);
-    out_attr=new void**[n];
-    ptrcheck(out_attr);
-    clear(out_attr, n);
+    if ((unsigned)n>NULL_NODE)
+      error("ARGraph_impl: too many nodes for node_id: %d", n);
+    int i, k;
+
+    // The attribute vectors are allocated at the first non NULL
+    // attribute, so a graph without attributes has none
+    attr=NULL;
     for(i=0; i<n; i++)
-      { int k=out_count[i]=loader->OutEdgeCount(i);
-        out[i]=new node_id[k];
-        ptrcheck(out[i]);
-        out_attr[i]=new void *[k];
-        ptrcheck(out_attr[i]);
-        for(j=0; j<k; j++)
-          { node_id n2=out[i][j]=loader->GetOutEdge(i, j, &out_attr[i][j]);
-            in_count[n2]++;
+      { void *a=loader->GetNodeAttr(i);
+        if (a!=NULL && attr==NULL)
+          { attr=new void*[n];
+            ptrcheck(attr);
+            clear(attr, n);
           }
+        if (attr!=NULL)
+          attr[i]=a;
       }
-    
+
+    // Offsets of the out lists
+    out_start=new int[n+1];
+    ptrcheck(out_start);
+    out_start[0]=0;
     for(i=0; i<n; i++)
-      { int k=in_count[i];
-        in[i]=new node_id[k];
-        ptrcheck(in[i]);
-        in_attr[i]=new void *[k];
-        ptrcheck(in_attr[i]);
-        int l=0;
-        for(j=0; j<n; j++)
-          { if (HasEdge(j,i))
-              { in[i][l]=j;
-                in_attr[i][l]=GetEdgeAttr(j, i);
-                l++;
+      out_start[i+1]=out_start[i]+loader->OutEdgeCount(i);
+    int m=out_start[n];
+
+    // Read the out lists, counting the in edges of each node
+    in_start=new int[n+1];
+    ptrcheck(in_start);
+    clear(in_start, n+1);
+    out_node=new node_id[m];
+    ptrcheck(out_node);
+    out_attr=NULL;
+    for(i=0; i<n; i++)
+      { for(k=out_start[i]; k<out_start[i+1]; k++)
+          { void *a;
+            node_id n2=out_node[k]=loader->GetOutEdge(i, k-out_start[i], &a);
+            if (a!=NULL && out_attr==NULL)
+              { out_attr=new void*[m];
+                ptrcheck(out_attr);
+                clear(out_attr, m);
               }
+            if (out_attr!=NULL)
+              out_attr[k]=a;
+            in_start[n2+1]++;
           }
-        assert(l==k);
       }
+    for(i=0; i<n; i++)
+      in_start[i+1]+=in_start[i];
+
+    // Build the in lists transposing the out lists; since the
+    // source nodes are visited in increasing order, each in list
+    // comes out sorted
+    in_node=new node_id[m];
+    ptrcheck(in_node);
+    in_attr=NULL;
+    if (out_attr!=NULL)
+      { in_attr=new void*[m];
+        ptrcheck(in_attr);
+      }
+    out_rev=new int[m];
+    ptrcheck(out_rev);
+    int *pos=new int[n];
+    ptrcheck(pos);
+    for(i=0; i<n; i++)
+      pos[i]=in_start[i];
+    for(i=0; i<n; i++)
+      { for(k=out_start[i]; k<out_start[i+1]; k++)
+          { int l=pos[out_node[k]]++;
+            out_rev[k]=l;
+            in_node[l]=i;
+            if (in_attr!=NULL)
+              in_attr[l]=out_attr[k];
+          }
+      }
+    delete[] pos;
+
+    // The graph is undirected if the sorted in and out lists
+    // of each node are equal
+    undirected=true;
+    for(i=0; i<n && undirected; i++)
+      { if (in_start[i+1]!=out_start[i+1])
+          undirected=false;
+        for(k=out_start[i]; k<out_start[i+1] && undirected; k++)
+          if (in_node[k]!=out_node[k])
+            undirected=false;
+      }
+
+    buildHashTables();
+  }
+
+/*---------------------------------------------------------------
+ * Constructor over edge vectors owned by the caller, which must
+ * outlive the graph and are never modified; the graph has no
+ * attributes. The vectors are as described in argraph.h, with
+ * out_rev giving the position in in_node of each 'out' edge.
+ --------------------------------------------------------------*/
+ARGraph_impl::ARGraph_impl(int n, int *out_start, node_id *out_node,
+                           int *in_start, node_id *in_node, int *out_rev,
+                           bool undirected)
+  { node_destroyer=NULL;
+    edge_destroyer=NULL;
+    node_comparator=NULL;
+    edge_comparator=NULL;
+    if ((unsigned)n>NULL_NODE)
+      error("ARGraph_impl: too many nodes for node_id: %d", n);
+    shared_edges=true;
+    this->n=n;
+    attr=NULL;
+    this->out_start=out_start;
+    this->out_node=out_node;
+    out_attr=NULL;
+    this->in_start=in_start;
+    this->in_node=in_node;
+    in_attr=NULL;
+    this->out_rev=out_rev;
+    this->undirected=undirected;
+
+    buildHashTables();
   }
 
 /*-------------------------------------------------
@@ -115,27 +193,27 @@ ARGraph_impl::ARGraph_impl(ARGLoader *loader)
  * Frees the memory allocated for the graph
  ------------------------------------------------*/
 ARGraph_impl::~ARGraph_impl()
-  { int i,j;
-    for(i=0; i<n; i++)
-      { 
-        for(j=0; j<out_count[i]; j++)
-            DestroyEdge(out_attr[i][j]);
-        delete[] in[i];
-        delete[] in_attr[i];
-        delete[] out[i];
-        delete[] out_attr[i];
-      }
+  { int i,k;
+    if (out_attr!=NULL)
+      for(k=0; k<out_start[n]; k++)
+        DestroyEdge(out_attr[k]);
 
-    for(i=0; i<n; i++)
-      DestroyNode(attr[i]);
+    if (attr!=NULL)
+      for(i=0; i<n; i++)
+        DestroyNode(attr[i]);
 
     delete[] attr;
     delete[] in_attr;
     delete[] out_attr;
-    delete[] in_count;
-    delete[] in;
-    delete[] out_count;
-    delete[] out;
+    if (!shared_edges)
+      { delete[] in_start;
+        delete[] in_node;
+        delete[] out_start;
+        delete[] out_node;
+        delete[] out_rev;
+      }
+    delete[] hash_start;
+    delete[] hash_slot;
     
     delete node_destroyer;
     delete edge_destroyer;
@@ -233,9 +311,18 @@ void ARGraph_impl::SetEdgeCompat(edge_compat_fn fn)
 
 /*-------------------------------------------------------------------
  * Change the attribute of a node
+ * Note: the attribute vector is allocated the first time a
+ *       non NULL attribute is set.
  -------------------------------------------------------------------*/
 void ARGraph_impl::SetNodeAttr(node_id i, void *new_attr, bool destroyOld)
-  { assert(i<n);
+  { assert(i<(node_id)n);
+    if (attr==NULL)
+      { if (new_attr==NULL)
+          return;
+        attr=new void*[n];
+        ptrcheck(attr);
+        clear(attr, n);
+      }
     if (destroyOld)
       DestroyNode(attr[i]);
     attr[i]=new_attr;
@@ -244,92 +331,146 @@ void ARGraph_impl::SetNodeAttr(node_id i, void *new_attr, bool destroyOld)
 /*-------------------------------------------------------------------
  * Checks the existence of an edge, and returns its attribute
  * using the parameter pattr.
- * Note: uses binary search.
- * Implem. note: Uses the out/out_attr vectors; this fact is 
- *               exploited in the constructor to generate the 
- *               in_attr vector
  ------------------------------------------------------------------*/
 bool ARGraph_impl::HasEdge(node_id n1, node_id n2, void **pattr)
-  { register int a, b, c;
-    node_id *id=out[n1];
-
-    assert(n1<n);
-    assert(n2<n);
-
-    a=0;
-    b=out_count[n1];
-    while (a<b)
-      { c=(unsigned)(a+b)>>1;
-        if (id[c]<n2)
-          a=c+1;
-        else if (id[c]>n2)
-          b=c;
-        else
-          { if (pattr)
-		      *pattr=out_attr[n1][c];
-			return true;
-		  }
-      }
-    return false;
+  { int c=FindEdge(n1, n2);
+    if (c<0)
+      return false;
+    if (pattr)
+      *pattr=out_attr? out_attr[c]: NULL;
+    return true;
   }
 
 /*-------------------------------------------------------------------
  * Change the attribute of an edge. It is an error if the edge
  * does not exist.
- * Note: uses binary search.
+ * Note: the attribute vectors are allocated the first time a
+ *       non NULL attribute is set.
  ------------------------------------------------------------------*/
 void  ARGraph_impl::SetEdgeAttr(node_id n1, node_id n2, void *new_attr,
                                 bool destroyOld)
-  { register int a, b, c;
-    node_id *id;
+  { int c=FindEdge(n1, n2);
+    if (c<0)
+      error("ARGraph_impl::SetEdgeAttr: non existent edge");
 
-    assert(n1<n);
-    assert(n2<n);
+    if (out_attr==NULL)
+      { if (new_attr==NULL)
+          return;
+        int m=out_start[n];
+        out_attr=new void*[m];
+        ptrcheck(out_attr);
+        clear(out_attr, m);
+        in_attr=new void*[m];
+        ptrcheck(in_attr);
+        clear(in_attr, m);
+      }
 
     //
     // Replace the attribute in the out_attr array
     //
-    id=out[n1];
-    a=0;
-    b=out_count[n1];
-    while (a<b)
-      { c=(unsigned)(a+b)>>1;
-        if (id[c]<n2)
-          a=c+1;
-        else if (id[c]>n2)
-          b=c;
-        else
-          { if (destroyOld)
-              DestroyEdge(out_attr[n1][c]);
-            out_attr[n1][c]=new_attr;
-	    break;
-          }
-      }
-    if (a>=b)
-      error("ARGraph_impl::SetEdgeAttr: non existent edge");
+    if (destroyOld)
+      DestroyEdge(out_attr[c]);
+    out_attr[c]=new_attr;
    
     //
-    // Replace the attribute in the in_attr array
+    // Replace the attribute in the in_attr array.
+    // The old attr here is intentionally not destroyed
+    // with DestroyEdge, since destruction has been
+    // performed previously through out_attr
     //
-    id = in[n2];
-    a=0;
-    b=in_count[n2];
+    in_attr[out_rev[c]]=new_attr;
+  }
+
+
+/*-------------------------------------------------------------------
+ * int ARGraph_impl::FindEdge(n1, n2)
+ * Returns the position (slot) of the edge (n1, n2) among the
+ * 'out' edges of the graph, or -1 if the edge does not exist.
+ * The slot gives the attribute of the edge (GetSlotAttr) and its
+ * position among the 'in' edges of n2 (GetReverseSlot) without
+ * further lookups.
+ * Note: uses the hash table of n1 if it has one, and binary
+ *       search otherwise.
+ ------------------------------------------------------------------*/
+int ARGraph_impl::FindEdge(node_id n1, node_id n2)
+  { int a, b, c;
+    node_id *id=out_node;
+
+    assert(n1<(node_id)n);
+    assert(n2<(node_id)n);
+
+    a=out_start[n1];
+    b=out_start[n1+1];
+    if (b-a>=HASH_MIN_DEGREE)
+      { int *table=hash_slot+hash_start[n1];
+        unsigned mask=hash_start[n1+1]-hash_start[n1]-1;
+        unsigned h=hash_node(n2)&mask;
+        while ((c=table[h])>=0)
+          { if (id[c]==n2)
+              return c;
+            h=(h+1)&mask;
+          }
+        return -1;
+      }
+
     while (a<b)
       { c=(unsigned)(a+b)>>1;
-        if (id[c]<n1)
+        if (id[c]<n2)
           a=c+1;
-        else if (id[c]>n1)
+        else if (id[c]>n2)
           b=c;
         else
-          { // The old attr here is intentionally
-	    // not destroyed with DestroyEdge, since destruction
-	    // has been performed previously through out_attr
-            in_attr[n2][c]=new_attr;
-	    break;
+          return c;
+      }
+    return -1;
+  }
+
+/*-------------------------------------------------------------------
+ * void ARGraph_impl::buildHashTables()
+ * Builds the hash tables of the nodes with at least
+ * HASH_MIN_DEGREE 'out' edges. Each table has a power of 2
+ * size, at least twice the degree.
+ ------------------------------------------------------------------*/
+void ARGraph_impl::buildHashTables()
+  { int i, k;
+    hash_start=NULL;
+    hash_slot=NULL;
+
+    bool any=false;
+    for(i=0; i<n && !any; i++)
+      if (out_start[i+1]-out_start[i]>=HASH_MIN_DEGREE)
+        any=true;
+    if (!any)
+      return;
+
+    hash_start=new int[n+1];
+    ptrcheck(hash_start);
+    hash_start[0]=0;
+    for(i=0; i<n; i++)
+      { int deg=out_start[i+1]-out_start[i];
+        int size=0;
+        if (deg>=HASH_MIN_DEGREE)
+          for(size=1; size<2*deg; size<<=1)
+            ;
+        hash_start[i+1]=hash_start[i]+size;
+      }
+
+    hash_slot=new int[hash_start[n]];
+    ptrcheck(hash_slot);
+    for(k=0; k<hash_start[n]; k++)
+      hash_slot[k]=-1;
+    for(i=0; i<n; i++)
+      { if (hash_start[i+1]==hash_start[i])
+          continue;
+        int *table=hash_slot+hash_start[i];
+        unsigned mask=hash_start[i+1]-hash_start[i]-1;
+        for(k=out_start[i]; k<out_start[i+1]; k++)
+          { unsigned h=hash_node(out_node[k])&mask;
+            while (table[h]>=0)
+              h=(h+1)&mask;
+            table[h]=k;
           }
       }
-    if (a>=b)
-      error("ARGraph_impl::SetEdgeAttr: inconsistent graph state");
   }
 
 
@@ -340,10 +481,10 @@ void  ARGraph_impl::SetEdgeAttr(node_id n1, node_id n2, void *new_attr,
 void ARGraph_impl::VisitInEdges(node_id node, edge_visitor vis, 
                                 param_type param)
   { 
-    assert(node<n);
-    int i;
-    for(i=0; i<in_count[node]; i++)
-      vis(this, in[node][i], node, in_attr[node][i], param);
+    assert(node<(node_id)n);
+    int k;
+    for(k=in_start[node]; k<in_start[node+1]; k++)
+      vis(this, in_node[k], node, in_attr? in_attr[k]: NULL, param);
   }
 
 /*-------------------------------------------------------------------
@@ -353,10 +494,10 @@ void ARGraph_impl::VisitInEdges(node_id node, edge_visitor vis,
 void ARGraph_impl::VisitOutEdges(node_id node, edge_visitor vis, 
                                  param_type param)
   {
-    assert(node<n); 
-    int i;
-    for(i=0; i<out_count[node]; i++)
-      vis(this, node, out[node][i], out_attr[node][i], param);
+    assert(node<(node_id)n); 
+    int k;
+    for(k=out_start[node]; k<out_start[node+1]; k++)
+      vis(this, node, out_node[k], out_attr? out_attr[k]: NULL, param);
   }
 
 /*-------------------------------------------------------------------
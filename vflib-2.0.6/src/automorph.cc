@@ -0,0 +1,512 @@
+/*------------------------------------------------------------------
+ * automorph.cc
+ * Implementation of the class AutomorphismGroup and of the
+ * functions match_group and match_all
+ *-----------------------------------------------------------------*/
+
+
+/*-----------------------------------------------------------------
+ *   IMPLEMENTATION NOTES
+ * searchFirst performs the usual depth-first search until the
+ * first isomorphism phi is found; then, while the recursion
+ * unwinds, exploreLevel tries the other candidates of each
+ * state along the path, so the deepest levels are explored
+ * first. At level d each candidate pair (base[d], n2)
+ * corresponds to the node x=phi^-1(n2) of g1; it is skipped if
+ * x is already known to be in the orbit of base[d], or in an
+ * orbit for which the search has already failed at this level.
+ * Otherwise a single match is searched for from the child
+ * state; if it is found, it gives a new generator, which fixes
+ * base[0]...base[d-1], and the orbits are merged.
+ * When the level is done, the orbit of base[d] contains all
+ * the nodes reachable by the automorphisms fixing the previous
+ * base nodes, and its length is stored in orbit_len[d].
+ *
+ * Visit uses, for each level with orbit_len[d]>1, a Schreier
+ * tree of the orbit of base[d] under the generators found at
+ * levels >= d: each automorphism is written in a unique way as
+ * u_0 o u_1 o ... where u_d maps base[d] to a node of its orbit.
+ *-----------------------------------------------------------------*/
+
+
+#include <stddef.h>
+
+#include "automorph.h"
+#include "error.h"
+
+
+/*----------------------------------------------------------
+ * Data used by visitLevel, built by
+ * AutomorphismGroup::Visit
+ ---------------------------------------------------------*/
+struct visit_data
+  { int n;
+    int levels;         // Number of levels with orbit_len>1
+    node_id **gen;
+    int **sv;           // Generator reaching each node, or -1
+    node_id **pred;     // Node from which it is reached
+    node_id **points;   // Nodes of each orbit
+    int *len;           // Length of each orbit
+    node_id **cur;      // Current mapping at each level
+    node_id *u;
+    int *chain;
+    node_id *ident;
+    match_visitor vis;
+    void *usr_data;
+    int count;
+  };
+
+static bool visitLevel(visit_data *vd, int k, node_id *prev);
+
+
+/*----------------------------------------------------------
+ * Methods of the class AutomorphismGroup
+ ---------------------------------------------------------*/
+
+/*----------------------------------------------------------
+ * AutomorphismGroup::AutomorphismGroup(n)
+ * Constructor. Makes the trivial group of a graph with
+ * n nodes.
+ ---------------------------------------------------------*/
+AutomorphismGroup::AutomorphismGroup(int an)
+  { n=an;
+    base=new node_id[n+1];
+    orbit_len=new int[n+1];
+    parent=new node_id[n+1];
+    orbit_size=new int[n+1];
+    fail_level=new int[n+1];
+    if (!base || !orbit_len || !parent || !orbit_size || !fail_level)
+      error("Out of memory");
+
+    gen=NULL;
+    gen_level=NULL;
+    gen_count=gen_size=0;
+    base_len=0;
+    phi_inv=c1=c2=NULL;
+
+    int i;
+    for(i=0; i<n; i++)
+      { parent[i]=i;
+        orbit_size[i]=1;
+      }
+  }
+
+
+/*----------------------------------------------------------
+ * AutomorphismGroup::~AutomorphismGroup()
+ * Destructor.
+ ---------------------------------------------------------*/
+AutomorphismGroup::~AutomorphismGroup()
+  { int i;
+    for(i=0; i<gen_count; i++)
+      delete[] gen[i];
+    delete[] gen;
+    delete[] gen_level;
+    delete[] base;
+    delete[] orbit_len;
+    delete[] parent;
+    delete[] orbit_size;
+    delete[] fail_level;
+  }
+
+
+/*----------------------------------------------------------
+ * bool AutomorphismGroup::Search(s0, phi)
+ * Searches an isomorphism between the graphs of the state
+ * s0, putting in phi[i] the node of g2 paired with node i
+ * of g1, and replaces the contents of the group with the
+ * automorphism group of g1.
+ * Returns false if the graphs are not isomorphic.
+ ---------------------------------------------------------*/
+bool AutomorphismGroup::Search(State *s0, node_id phi[])
+  { if (s0->GetGraph1()->NodeCount()!=n)
+      error("AutomorphismGroup: the graph must have %d nodes", n);
+
+    int i;
+    for(i=0; i<gen_count; i++)
+      delete[] gen[i];
+    gen_count=0;
+    base_len=0;
+    for(i=0; i<n; i++)
+      { parent[i]=i;
+        orbit_size[i]=1;
+        fail_level[i]=-1;
+      }
+
+    if (s0->GetGraph2()->NodeCount()!=n)
+      return false;
+
+    phi_inv=new node_id[n+1];
+    c1=new node_id[n+1];
+    c2=new node_id[n+1];
+    if (!phi_inv || !c1 || !c2)
+      error("Out of memory");
+
+    bool found=searchFirst(s0, 0, phi);
+
+    delete[] phi_inv;
+    delete[] c1;
+    delete[] c2;
+    phi_inv=c1=c2=NULL;
+    return found;
+  }
+
+
+/*----------------------------------------------------------
+ * node_id AutomorphismGroup::Orbit(node)
+ * Returns the representative of the orbit of node under
+ * the generators found.
+ ---------------------------------------------------------*/
+node_id AutomorphismGroup::Orbit(node_id node)
+  { while (parent[node]!=node)
+      { parent[node]=parent[parent[node]];
+        node=parent[node];
+      }
+    return node;
+  }
+
+
+/*----------------------------------------------------------
+ * double AutomorphismGroup::Order()
+ * Returns the number of automorphisms of g1, that is also
+ * the number of isomorphisms between g1 and g2.
+ * A double is used since the order easily exceeds the
+ * range of the integer types.
+ ---------------------------------------------------------*/
+double AutomorphismGroup::Order()
+  { double order=1;
+    int d;
+    for(d=0; d<base_len; d++)
+      order*=orbit_len[d];
+    return order;
+  }
+
+
+/*----------------------------------------------------------
+ * int AutomorphismGroup::Visit(phi, vis, usr_data)
+ * Visits all the isomorphisms phi o a, for each automorphism
+ * a of the group, calling vis with c1[i]=i and c2[i] equal
+ * to the node paired with i.
+ * Returns the number of visited matches.
+ * Stops when there are no more matches, or the visitor vis
+ * returns true.
+ ---------------------------------------------------------*/
+int AutomorphismGroup::Visit(node_id phi[], match_visitor vis,
+                             void *usr_data)
+  { visit_data vd;
+    int i, j, d, k;
+
+    vd.n=n;
+    vd.gen=gen;
+    vd.vis=vis;
+    vd.usr_data=usr_data;
+    vd.count=0;
+
+    vd.levels=0;
+    for(d=0; d<base_len; d++)
+      if (orbit_len[d]>1)
+        vd.levels++;
+
+    vd.sv=new int*[vd.levels+1];
+    vd.pred=new node_id*[vd.levels+1];
+    vd.points=new node_id*[vd.levels+1];
+    vd.cur=new node_id*[vd.levels+1];
+    vd.len=new int[vd.levels+1];
+    vd.u=new node_id[n+1];
+    vd.chain=new int[n+1];
+    vd.ident=new node_id[n+1];
+    if (!vd.sv || !vd.pred || !vd.points || !vd.cur || !vd.len ||
+        !vd.u || !vd.chain || !vd.ident)
+      error("Out of memory");
+    for(i=0; i<n; i++)
+      vd.ident[i]=i;
+
+    // Build the Schreier tree of each non trivial level
+    for(d=0, k=0; d<base_len; d++)
+      { if (orbit_len[d]<=1)
+          continue;
+        int *sv=vd.sv[k]=new int[n];
+        node_id *pred=vd.pred[k]=new node_id[n];
+        node_id *points=vd.points[k]=new node_id[orbit_len[d]];
+        vd.cur[k]=new node_id[n+1];
+        if (!sv || !pred || !points || !vd.cur[k])
+          error("Out of memory");
+
+        for(i=0; i<n; i++)
+          sv[i]=-2;
+        sv[base[d]]=-1;
+        points[0]=base[d];
+        int len=1, head;
+        for(head=0; head<len; head++)
+          { node_id p=points[head];
+            for(j=0; j<gen_count; j++)
+              { if (gen_level[j]<d)
+                  continue;
+                node_id q=gen[j][p];
+                if (sv[q]==-2)
+                  { if (len==orbit_len[d])
+                      CANT_HAPPEN();
+                    sv[q]=j;
+                    pred[q]=p;
+                    points[len++]=q;
+                  }
+              }
+          }
+        if (len!=orbit_len[d])
+          CANT_HAPPEN();
+        vd.len[k]=len;
+        k++;
+      }
+
+    visitLevel(&vd, 0, phi);
+
+    for(k=0; k<vd.levels; k++)
+      { delete[] vd.sv[k];
+        delete[] vd.pred[k];
+        delete[] vd.points[k];
+        delete[] vd.cur[k];
+      }
+    delete[] vd.sv;
+    delete[] vd.pred;
+    delete[] vd.points;
+    delete[] vd.cur;
+    delete[] vd.len;
+    delete[] vd.u;
+    delete[] vd.chain;
+    delete[] vd.ident;
+    return vd.count;
+  }
+
+
+/*----------------------------------------------------------
+ * bool AutomorphismGroup::searchFirst(s, level, phi)
+ * Searches the first isomorphism starting from state s,
+ * which is at the given level of the SSR; then explores
+ * the other candidates of s (see exploreLevel).
+ * Returns true if an isomorphism has been found.
+ ---------------------------------------------------------*/
+bool AutomorphismGroup::searchFirst(State *s, int level, node_id phi[])
+  { if (s->IsGoal())
+      { int i;
+        s->GetCoreSet(c1, c2);
+        for(i=0; i<n; i++)
+          { phi[c1[i]]=c2[i];
+            phi_inv[c2[i]]=c1[i];
+          }
+        base_len=level;
+        return true;
+      }
+
+    if (s->IsDead())
+      return false;
+
+    node_id n1=NULL_NODE, n2=NULL_NODE;
+    while (s->NextPair(&n1, &n2, n1, n2))
+      { if (s->IsFeasiblePair(n1, n2))
+          { State *s1=s->Clone();
+            s1->AddPair(n1, n2);
+            bool found=searchFirst(s1, level+1, phi);
+            s1->BackTrack();
+            delete s1;
+            if (found)
+              { base[level]=n1;
+                exploreLevel(s, level, n1, n2);
+                return true;
+              }
+          }
+      }
+    return false;
+  }
+
+
+/*----------------------------------------------------------
+ * void AutomorphismGroup::exploreLevel(s, level, n1, n2)
+ * Tries the candidates of state s following (n1, n2),
+ * the pair leading to phi, skipping the ones equivalent
+ * under the generators found so far, and adds a generator
+ * for each new candidate having a match.
+ ---------------------------------------------------------*/
+void AutomorphismGroup::exploreLevel(State *s, int level,
+                                     node_id n1, node_id n2)
+  { node_id b=n1;
+    node_id *perm=new node_id[n+1];
+    if (!perm)
+      error("Out of memory");
+
+    while (s->NextPair(&n1, &n2, n1, n2) && n1==b)
+      { node_id x=phi_inv[n2];
+        node_id r=Orbit(x);
+        if (r==Orbit(b) || fail_level[r]==level)
+          continue;
+
+        bool found=false;
+        if (s->IsFeasiblePair(n1, n2))
+          { State *s1=s->Clone();
+            s1->AddPair(n1, n2);
+            int i, k;
+            if (match(s1, &k, c1, c2))
+              { for(i=0; i<k; i++)
+                  perm[c1[i]]=phi_inv[c2[i]];
+                found=true;
+              }
+            s1->BackTrack();
+            delete s1;
+          }
+
+        if (found)
+          addGenerator(perm, level);
+        else
+          fail_level[r]=level;
+      }
+
+    orbit_len[level]=orbit_size[Orbit(b)];
+    delete[] perm;
+  }
+
+
+/*----------------------------------------------------------
+ * void AutomorphismGroup::addGenerator(perm, level)
+ * Adds a copy of perm to the generators, and merges the
+ * orbits of the nodes it exchanges.
+ ---------------------------------------------------------*/
+void AutomorphismGroup::addGenerator(node_id *perm, int level)
+  { if (gen_count==gen_size)
+      { int size=gen_size? 2*gen_size: 8;
+        node_id **g=new node_id*[size];
+        int *l=new int[size];
+        if (!g || !l)
+          error("Out of memory");
+        int i;
+        for(i=0; i<gen_count; i++)
+          { g[i]=gen[i];
+            l[i]=gen_level[i];
+          }
+        delete[] gen;
+        delete[] gen_level;
+        gen=g;
+        gen_level=l;
+        gen_size=size;
+      }
+
+    node_id *p=new node_id[n+1];
+    if (!p)
+      error("Out of memory");
+    int i;
+    for(i=0; i<n; i++)
+      { p[i]=perm[i];
+        unite(i, perm[i], level);
+      }
+    gen[gen_count]=p;
+    gen_level[gen_count]=level;
+    gen_count++;
+  }
+
+
+/*----------------------------------------------------------
+ * void AutomorphismGroup::unite(a, b, level)
+ * Merges the orbits of a and b.
+ ---------------------------------------------------------*/
+void AutomorphismGroup::unite(node_id a, node_id b, int level)
+  { a=Orbit(a);
+    b=Orbit(b);
+    if (a==b)
+      return;
+    if (orbit_size[a]<orbit_size[b])
+      { node_id t=a;
+        a=b;
+        b=t;
+      }
+    parent[b]=a;
+    orbit_size[a]+=orbit_size[b];
+    if (fail_level[b]==level)
+      fail_level[a]=level;
+  }
+
+
+/*----------------------------------------------------------
+ * bool match_group(s0, phi, aut)
+ * Finds an isomorphism phi between the graphs of state s0,
+ * if it exists, and the automorphism group of g1 (see
+ * AutomorphismGroup::Search).
+ * aut must have been built with the number of nodes of g1.
+ * Returns true if the graphs are isomorphic.
+ ---------------------------------------------------------*/
+bool match_group(State *s0, node_id phi[], AutomorphismGroup *aut)
+  { return aut->Search(s0, phi);
+  }
+
+
+/*----------------------------------------------------------
+ * int match_all(s0, vis, usr_data)
+ * Visits all the isomorphisms between the graphs of state
+ * s0, as the function match of match.h does, but exploring
+ * only one branch for each generator of the automorphism
+ * group of g1.
+ * Returns the number of visited matches.
+ * Stops when there are no more matches, or the visitor vis
+ * returns true.
+ ---------------------------------------------------------*/
+int match_all(State *s0, match_visitor vis, void *usr_data)
+  { int n=s0->GetGraph1()->NodeCount();
+    AutomorphismGroup aut(n);
+    node_id *phi=new node_id[n+1];
+    if (!phi)
+      error("Out of memory");
+
+    int count=0;
+    if (aut.Search(s0, phi))
+      count=aut.Visit(phi, vis, usr_data);
+
+    delete[] phi;
+    return count;
+  }
+
+
+
+/*---------------------------------------------------------
+ * Static functions
+ --------------------------------------------------------*/
+
+/*----------------------------------------------------------
+ * Visits the automorphisms u_k o u_k+1 o ... for each
+ * choice of the transversal elements of the non trivial
+ * levels from k on, composed with prev.
+ * Returns true if the visitor has requested to stop.
+ ---------------------------------------------------------*/
+static bool visitLevel(visit_data *vd, int k, node_id *prev)
+  { if (k==vd->levels)
+      { vd->count++;
+        return vd->vis(vd->n, vd->ident, prev, vd->usr_data);
+      }
+
+    int n=vd->n;
+    int *sv=vd->sv[k];
+    node_id *pred=vd->pred[k];
+    node_id *cur=vd->cur[k];
+    node_id *u=vd->u;
+    int *chain=vd->chain;
+    int p, i, j;
+
+    for(p=0; p<vd->len[k]; p++)
+      { // u is the product of the generators along the path
+        // from the root of the Schreier tree to points[p]
+        node_id x=vd->points[k][p];
+        int clen=0;
+        while (sv[x]>=0)
+          { chain[clen++]=sv[x];
+            x=pred[x];
+          }
+        for(i=0; i<n; i++)
+          { node_id y=i;
+            for(j=clen-1; j>=0; j--)
+              y=vd->gen[chain[j]][y];
+            u[i]=y;
+          }
+
+        for(i=0; i<n; i++)
+          cur[i]=prev[u[i]];
+        if (visitLevel(vd, k+1, cur))
+          return true;
+      }
+    return false;
+  }
@@ -0,0 +1,449 @@
+/*------------------------------------------------------------------
+ * canon.cc
+ * Implementation of the canonical form and of the certificate
+ * of a graph
+ *-----------------------------------------------------------------*/
+
+
+/*-----------------------------------------------------------------
+ *   IMPLEMENTATION NOTES
+ * A partition is an ordered list of classes (cells); it is
+ * represented by the vector lab, containing the nodes cell by
+ * cell, and by the vectors cell (the position of the first
+ * node of the cell of each node) and len (the length of the
+ * cell starting at each position). The position of a cell is
+ * used as its identifier, which does not depend on the
+ * numbering of the nodes.
+ *
+ * The refinement splits each cell according to a signature
+ * of its nodes, that is a hash of the multisets of the cells
+ * of their out and in neighbours. A collision of two
+ * signatures can only make the partition coarser, so it
+ * never affects the correctness of the canonical form.
+ * During the refinement a hash (the trace) of the cells and
+ * signatures is computed; the trace does not depend on the
+ * numbering of the nodes either.
+ *
+ * The leaves of the search tree (discrete partitions) are
+ * compared first by the sequence of the traces along their
+ * path, and then by the relabeled edge list (the code); the
+ * canonical order is the one of the smallest leaf. A subtree
+ * is pruned if the traces along its path are already greater
+ * than the ones of the best leaf, or if its root is the image
+ * of an already explored sibling under an automorphism fixing
+ * the nodes individualized so far. Two leaves with equal
+ * traces and codes give an automorphism; the subtree where
+ * the current path leaves the path of the best leaf is then
+ * the image of an already explored one, and the search goes
+ * back directly to its root (the jump field).
+ *-----------------------------------------------------------------*/
+
+
+#include <stddef.h>
+#include <algorithm>
+#include <vector>
+
+#include "canon.h"
+#include "reachcount.h"
+#include "hashmix.h"
+#include "error.h"
+
+
+typedef unsigned long long uint64;
+
+struct partition
+  { std::vector<node_id> lab;
+    std::vector<int> cell;
+    std::vector<int> len;
+  };
+
+
+/*----------------------------------------------------------
+ * class Canonizer
+ * The search of the canonical form of a graph
+ ---------------------------------------------------------*/
+class Canonizer
+  { private:
+      Graph *g;
+      int n;
+      std::vector<uint64> sig;
+      std::vector<uint64> trace, best_trace;
+      std::vector<uint64> code, best_code;
+      std::vector<node_id> best_lab;
+      bool have_best;
+      std::vector<node_id> fixed, best_fixed;
+      int jump;
+      std::vector< std::vector<node_id> > gens;
+      std::vector<int> pos;
+
+      uint64 refine(partition &p);
+      void individualize(partition &p, node_id v);
+      int compareTrace();
+      void makeCode(partition &p);
+      void leaf(partition &p);
+      void orbits(std::vector<node_id> &orb);
+      void search(partition &p);
+
+    public:
+      Canonizer(Graph *g) { this->g=g; n=g->NodeCount(); }
+      void Run(node_class_fn cls);
+      node_id *BestLab() { return n>0? &best_lab[0]: NULL; }
+      std::vector<uint64> &BestCode() { return best_code; }
+  };
+
+
+/*----------------------------------------------------------
+ * Sorting of the nodes by the key of the initial partition
+ ---------------------------------------------------------*/
+struct key_less
+  { std::vector<int> *keys;
+    int size;
+    bool operator()(node_id a, node_id b) const
+      { int i;
+        for(i=0; i<size; i++)
+          if ((*keys)[a*size+i]!=(*keys)[b*size+i])
+            return (*keys)[a*size+i]<(*keys)[b*size+i];
+        return false;
+      }
+  };
+
+struct sig_less
+  { std::vector<uint64> *sig;
+    bool operator()(node_id a, node_id b) const
+      { return (*sig)[a]<(*sig)[b];
+      }
+  };
+
+
+/*----------------------------------------------------------
+ * void Canonizer::Run(cls)
+ * Builds the initial partition and performs the search.
+ ---------------------------------------------------------*/
+void Canonizer::Run(node_class_fn cls)
+  { int i, j, k;
+    const int ksize=3+REACH_SIZE;
+
+    have_best=false;
+    jump= -1;
+    sig.resize(n);
+    pos.resize(n);
+
+    // Initial partition, by node class, degrees and reach counts
+    int *reach=ComputeReachCounts(g);
+    std::vector<int> keys(n*ksize+1);
+    for(i=0; i<n; i++)
+      { keys[i*ksize]= cls? cls(g->GetNodeAttr(i)): 0;
+        keys[i*ksize+1]=g->OutEdgeCount(i);
+        keys[i*ksize+2]=g->InEdgeCount(i);
+        for(k=0; k<REACH_SIZE; k++)
+          keys[i*ksize+3+k]=reach[i*REACH_SIZE+k];
+      }
+    delete[] reach;
+
+    partition p;
+    p.lab.resize(n);
+    p.cell.resize(n);
+    p.len.resize(n+1);
+    for(i=0; i<n; i++)
+      p.lab[i]=i;
+    key_less kl;
+    kl.keys=&keys;
+    kl.size=ksize;
+    std::sort(p.lab.begin(), p.lab.end(), kl);
+
+    uint64 t=hash_mix(n);
+    for(i=0; i<n; i=j)
+      { for(j=i+1; j<n && !kl(p.lab[i], p.lab[j]); j++)
+          ;
+        p.len[i]=j-i;
+        for(k=i; k<j; k++)
+          p.cell[p.lab[k]]=i;
+        t=hash_mix(t^(uint64)(j-i));
+        for(k=0; k<ksize; k++)
+          t=hash_mix(t^(uint64)(unsigned)keys[p.lab[i]*ksize+k]);
+      }
+
+    trace.push_back(hash_mix(t^refine(p)));
+    search(p);
+  }
+
+
+/*----------------------------------------------------------
+ * uint64 Canonizer::refine(p)
+ * Refines the partition p until the nodes of each cell
+ * have the same signature. Returns the trace.
+ ---------------------------------------------------------*/
+uint64 Canonizer::refine(partition &p)
+  { uint64 t=0;
+    bool split=true;
+    int i, j, k, v;
+    sig_less sl;
+    sl.sig=&sig;
+
+    while (split)
+      { split=false;
+        for(v=0; v<n; v++)
+          { uint64 s=0;
+            for(k=0; k<g->OutEdgeCount(v); k++)
+              s+=hash_mix(2*(uint64)p.cell[g->GetOutEdge(v, k)]);
+            for(k=0; k<g->InEdgeCount(v); k++)
+              s+=hash_mix(2*(uint64)p.cell[g->GetInEdge(v, k)]+1);
+            sig[v]=s;
+          }
+
+        int end;
+        for(i=0; i<n; i=end)
+          { end=i+p.len[i];
+            if (p.len[i]==1)
+              continue;
+            std::sort(p.lab.begin()+i, p.lab.begin()+end, sl);
+            int start=i;
+            for(j=i+1; j<=end; j++)
+              if (j==end || sig[p.lab[j]]!=sig[p.lab[j-1]])
+                { p.len[start]=j-start;
+                  for(k=start; k<j; k++)
+                    p.cell[p.lab[k]]=start;
+                  t=hash_mix(t^hash_mix(sig[p.lab[start]]+(uint64)start));
+                  t=hash_mix(t^(uint64)(j-start));
+                  if (j<end)
+                    split=true;
+                  start=j;
+                }
+          }
+      }
+    return t;
+  }
+
+
+/*----------------------------------------------------------
+ * void Canonizer::individualize(p, v)
+ * Puts node v in a cell of its own, just before the other
+ * nodes of its cell.
+ ---------------------------------------------------------*/
+void Canonizer::individualize(partition &p, node_id v)
+  { int s=p.cell[v];
+    int l=p.len[s];
+    int i;
+    for(i=s; p.lab[i]!=v; i++)
+      ;
+    p.lab[i]=p.lab[s];
+    p.lab[s]=v;
+    p.len[s]=1;
+    p.len[s+1]=l-1;
+    for(i=s+1; i<s+l; i++)
+      p.cell[p.lab[i]]=s+1;
+  }
+
+
+/*----------------------------------------------------------
+ * int Canonizer::compareTrace()
+ * Compares the traces of the current path with the ones
+ * of the best leaf, up to the length of the current path.
+ * Returns -1, 0 or 1.
+ ---------------------------------------------------------*/
+int Canonizer::compareTrace()
+  { int l=trace.size(), b=best_trace.size();
+    int i;
+    for(i=0; i<l && i<b; i++)
+      if (trace[i]!=best_trace[i])
+        return trace[i]<best_trace[i]? -1: 1;
+    return l>b? 1: 0;
+  }
+
+
+/*----------------------------------------------------------
+ * void Canonizer::makeCode(p)
+ * Puts in code the sorted list of the edges of the graph,
+ * relabeled according to the discrete partition p.
+ ---------------------------------------------------------*/
+void Canonizer::makeCode(partition &p)
+  { int i, k;
+    for(i=0; i<n; i++)
+      pos[p.lab[i]]=i;
+    code.clear();
+    for(i=0; i<n; i++)
+      for(k=0; k<g->OutEdgeCount(i); k++)
+        code.push_back((uint64)pos[i]*n+pos[g->GetOutEdge(i, k)]);
+    std::sort(code.begin(), code.end());
+  }
+
+
+/*----------------------------------------------------------
+ * void Canonizer::leaf(p)
+ * Compares the discrete partition p with the best leaf,
+ * replacing it or recording an automorphism.
+ ---------------------------------------------------------*/
+void Canonizer::leaf(partition &p)
+  { makeCode(p);
+    int c=compareTrace();
+    if (c==0 && trace.size()<best_trace.size())
+      c= -1;
+    if (c==0)
+      { if (code<best_code)
+          c= -1;
+        else if (code==best_code)
+          { std::vector<node_id> a(n);
+            bool identity=true;
+            int i;
+            for(i=0; i<n; i++)
+              { a[p.lab[i]]=best_lab[i];
+                if (p.lab[i]!=best_lab[i])
+                  identity=false;
+              }
+            if (!identity)
+              { gens.push_back(a);
+                for(i=0; i<(int)fixed.size() && fixed[i]==best_fixed[i]; i++)
+                  ;
+                jump=i;
+              }
+          }
+      }
+
+    if (!have_best || c<0)
+      { have_best=true;
+        best_trace=trace;
+        best_code.swap(code);
+        best_lab=p.lab;
+        best_fixed=fixed;
+      }
+  }
+
+
+/*----------------------------------------------------------
+ * void Canonizer::orbits(orb)
+ * Computes in orb the union-find forest of the orbits of
+ * the automorphisms found so far that fix the nodes
+ * individualized along the current path.
+ ---------------------------------------------------------*/
+static node_id find(std::vector<node_id> &orb, node_id v)
+  { while (orb[v]!=v)
+      { orb[v]=orb[orb[v]];
+        v=orb[v];
+      }
+    return v;
+  }
+
+void Canonizer::orbits(std::vector<node_id> &orb)
+  { int i, j;
+    orb.resize(n);
+    for(i=0; i<n; i++)
+      orb[i]=i;
+    for(j=0; j<(int)gens.size(); j++)
+      { std::vector<node_id> &a=gens[j];
+        for(i=0; i<(int)fixed.size() && a[fixed[i]]==fixed[i]; i++)
+          ;
+        if (i<(int)fixed.size())
+          continue;
+        for(i=0; i<n; i++)
+          { node_id x=find(orb, i), y=find(orb, a[i]);
+            if (x!=y)
+              orb[x]=y;
+          }
+      }
+  }
+
+
+/*----------------------------------------------------------
+ * void Canonizer::search(p)
+ * Explores the subtree rooted at the refined partition p.
+ ---------------------------------------------------------*/
+void Canonizer::search(partition &p)
+  { if (have_best && compareTrace()>0)
+      return;
+
+    // Choose the first smallest non trivial cell
+    int i, j, target=-1;
+    for(i=0; i<n; i+=p.len[i])
+      if (p.len[i]>1 && (target<0 || p.len[i]<p.len[target]))
+        target=i;
+    if (target<0)
+      { leaf(p);
+        return;
+      }
+
+    std::vector<node_id> cand(p.lab.begin()+target,
+                              p.lab.begin()+target+p.len[target]);
+    std::vector<node_id> done;
+    std::vector<node_id> orb;
+    int seen_gens=-1;
+    for(i=0; i<(int)cand.size(); i++)
+      { node_id w=cand[i];
+        if (!done.empty())
+          { if (seen_gens!=(int)gens.size())
+              { orbits(orb);
+                seen_gens=gens.size();
+              }
+            for(j=0; j<(int)done.size() &&
+                     find(orb, done[j])!=find(orb, w); j++)
+              ;
+            if (j<(int)done.size())
+              continue;
+          }
+
+        partition q=p;
+        individualize(q, w);
+        trace.push_back(hash_mix(hash_mix((uint64)target)^refine(q)));
+        fixed.push_back(w);
+        search(q);
+        fixed.pop_back();
+        trace.pop_back();
+        done.push_back(w);
+        if (jump>=0)
+          { if ((int)fixed.size()>jump)
+              return;
+            jump= -1;
+          }
+      }
+  }
+
+
+/*----------------------------------------------------------
+ * void CanonicalForm(g, order, cert, cls)
+ * Computes a canonical order of the nodes of g, putting in
+ * order[i] the node at the i-th position, and the
+ * certificate of g. Either order or cert can be NULL.
+ * cls, if not NULL, is used to partition the nodes
+ * according to their attributes.
+ ---------------------------------------------------------*/
+void CanonicalForm(Graph *g, node_id order[], GraphCertificate *cert,
+                   node_class_fn cls)
+  { Canonizer c(g);
+    int n=g->NodeCount();
+    int i;
+
+    c.Run(cls);
+    node_id *lab=c.BestLab();
+    if (order!=NULL)
+      for(i=0; i<n; i++)
+        order[i]=lab[i];
+
+    if (cert!=NULL)
+      { std::vector<uint64> &code=c.BestCode();
+        uint64 h1=hash_mix(0x43414e4f4e31ULL^(uint64)n);
+        uint64 h2=hash_mix(0x43414e4f4e32ULL+(uint64)n);
+        if (cls!=NULL)
+          for(i=0; i<n; i++)
+            { uint64 x=(uint64)(unsigned)cls(g->GetNodeAttr(lab[i]));
+              h1=hash_mix(h1^x);
+              h2=hash_mix(h2+hash_mix(x+i));
+            }
+        h1=hash_mix(h1^(uint64)code.size());
+        for(i=0; i<(int)code.size(); i++)
+          { h1=hash_mix(h1^code[i]);
+            h2=hash_mix(h2+hash_mix(code[i]*0x2545f4914f6cdd1dULL+i));
+          }
+        cert->hi=h1;
+        cert->lo=h2;
+      }
+  }
+
+
+/*----------------------------------------------------------
+ * GraphCertificate ComputeCertificate(g, cls)
+ * Returns the certificate of g.
+ ---------------------------------------------------------*/
+GraphCertificate ComputeCertificate(Graph *g, node_class_fn cls)
+  { GraphCertificate cert;
+    CanonicalForm(g, NULL, &cert, cls);
+    return cert;
+  }
@@ -0,0 +1,361 @@
+/*------------------------------------------------------------------
+ * components.cc
+ * Implementation of the decomposition into weakly connected
+ * components and of component_match
+ *-----------------------------------------------------------------*/
+
+
+/*-----------------------------------------------------------------
+ *   IMPLEMENTATION NOTES
+ * The nodes of a graph are listed component by component in
+ * the vector nodes of ComponentSet; the position of a node in
+ * its component is its id in the extracted graph. The
+ * extracted graphs share the attributes of the original one,
+ * and forward the compatibility tests to g1 through a
+ * ForwardComparator.
+ *
+ * The matching of the components of the k-th pair is written
+ * in c1 and c2 at the position of the first node of the
+ * component of g1 in its node list, so the threads write to
+ * disjoint parts of the vectors.
+ *-----------------------------------------------------------------*/
+
+
+#include <stddef.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "components.h"
+#include "graphindex.h"
+#include "argedit.h"
+#include "match.h"
+#include "my_vf2_state.h"
+#include "error.h"
+
+
+/*----------------------------------------------------------
+ * class ForwardComparator
+ * Tests the compatibility of the attributes using the
+ * comparators of another graph
+ ---------------------------------------------------------*/
+class ForwardComparator: public AttrComparator
+  { private:
+      Graph *g;
+      bool edges;
+    public:
+      ForwardComparator(Graph *g, bool edges)
+          { this->g=g; this->edges=edges; }
+      virtual bool compatible(void *attr1, void *attr2)
+          { return edges? g->CompatibleEdge(attr1, attr2)
+                        : g->CompatibleNode(attr1, attr2);
+          }
+  };
+
+
+/*----------------------------------------------------------
+ * class ComponentSet
+ * The components of a graph
+ ---------------------------------------------------------*/
+class ComponentSet
+  { public:
+      Graph *g;
+      int count;
+      std::vector<int> comp;
+      std::vector<int> start;    // The nodes of the k-th component are
+      std::vector<node_id> nodes;// nodes[start[k]] ... nodes[start[k+1]-1]
+      std::vector<Graph*> graphs;
+      std::vector<graph_index_key> keys;
+      std::vector<int> order;    // The components sorted by key
+
+      ComponentSet(Graph *g);
+      ~ComponentSet();
+      int Size(int k) { return start[k+1]-start[k]; }
+      void Extract(Graph *cmp);
+  };
+
+struct match_data
+  { ComponentSet *set1, *set2;
+    std::vector<int> group;      // Positions in order where the groups begin
+    std::atomic<int> next_group;
+    std::atomic<bool> failed;
+    component_state_fn make_state;
+    node_id *c1, *c2;
+  };
+
+
+static State *make_my_vf2_state(Graph *g1, Graph *g2);
+static void match_groups(match_data *md);
+
+
+/*----------------------------------------------------------
+ * int WeakComponents(g, comp)
+ * Finds the weakly connected components of g, i.e. the ones
+ * obtained ignoring the direction of the edges. comp[i] is
+ * assigned the component of node i; the components are
+ * numbered from 0 in the order of their smallest node.
+ * Returns the number of components.
+ ---------------------------------------------------------*/
+int WeakComponents(Graph *g, int comp[])
+  { int n=g->NodeCount();
+    int i, j, count=0;
+
+    node_id *queue=new node_id[n];
+    if (n>0 && !queue)
+      error("Out of memory");
+    for(i=0; i<n; i++)
+      comp[i]=-1;
+
+    for(i=0; i<n; i++)
+      { if (comp[i]>=0)
+          continue;
+        int head=0, tail=0;
+        comp[i]=count;
+        queue[tail++]=i;
+        while (head<tail)
+          { node_id u=queue[head++];
+            for(j=0; j<g->OutEdgeCount(u); j++)
+              { node_id w=g->GetOutEdge(u, j);
+                if (comp[w]<0)
+                  { comp[w]=count;
+                    queue[tail++]=w;
+                  }
+              }
+            for(j=0; j<g->InEdgeCount(u); j++)
+              { node_id w=g->GetInEdge(u, j);
+                if (comp[w]<0)
+                  { comp[w]=count;
+                    queue[tail++]=w;
+                  }
+              }
+          }
+        count++;
+      }
+
+    delete[] queue;
+    return count;
+  }
+
+
+/*----------------------------------------------------------
+ * bool component_match(g1, g2, pn, c1, c2,
+ *                      nthreads, make_state)
+ * Finds an isomorphism between g1 and g2 matching their
+ * weakly connected components separately, with nthreads
+ * threads; the state for each pair of components is built
+ * by make_state, or is a MyVF2State if make_state is NULL.
+ * Returns true if the graphs are isomorphic; *pn is then
+ * assigned the number of nodes, and c1 and c2 will contain
+ * the ids of the corresponding nodes in the two graphs.
+ ---------------------------------------------------------*/
+bool component_match(Graph *g1, Graph *g2,
+                     int *pn, node_id c1[], node_id c2[],
+                     int nthreads, component_state_fn make_state)
+  { int n=g1->NodeCount();
+    if (n!=g2->NodeCount())
+      return false;
+    if (make_state==NULL)
+      make_state=make_my_vf2_state;
+    if (nthreads<1)
+      nthreads=1;
+
+    ComponentSet set1(g1), set2(g2);
+    if (set1.count!=set2.count)
+      return false;
+
+    // Compare the multisets of the component sizes
+    int k;
+    std::vector<int> size1(set1.count), size2(set2.count);
+    for(k=0; k<set1.count; k++)
+      { size1[k]=set1.Size(k);
+        size2[k]=set2.Size(k);
+      }
+    std::sort(size1.begin(), size1.end());
+    std::sort(size2.begin(), size2.end());
+    if (size1!=size2)
+      return false;
+
+    // Compare the multisets of the keys
+    set1.Extract(g1);
+    set2.Extract(g1);
+    for(k=0; k<set1.count; k++)
+      if (set1.keys[set1.order[k]]!=set2.keys[set2.order[k]])
+        return false;
+
+    match_data md;
+    md.set1=&set1;
+    md.set2=&set2;
+    for(k=0; k<set1.count; k++)
+      if (k==0 || set1.keys[set1.order[k]]!=set1.keys[set1.order[k-1]])
+        md.group.push_back(k);
+    md.group.push_back(set1.count);
+    md.next_group=0;
+    md.failed=false;
+    md.make_state=make_state;
+    md.c1=c1;
+    md.c2=c2;
+
+    int ngroups=md.group.size()-1;
+    if (nthreads>ngroups)
+      nthreads=ngroups;
+    std::vector<std::thread> threads;
+    int i;
+    for(i=1; i<nthreads; i++)
+      threads.push_back(std::thread(match_groups, &md));
+    match_groups(&md);
+    for(i=0; i<(int)threads.size(); i++)
+      threads[i].join();
+
+    if (md.failed)
+      return false;
+    *pn=n;
+    return true;
+  }
+
+
+
+/*---------------------------------------------------------
+ * Static functions and methods of ComponentSet
+ --------------------------------------------------------*/
+
+static State *make_my_vf2_state(Graph *g1, Graph *g2)
+  { return new MyVF2State(g1, g2);
+  }
+
+
+/*-------------------------------------------------------------
+ * Takes the groups of components with the same key, and
+ * pairs each component of g1 in the group with an isomorphic
+ * one of g2, until there are no more groups or a component
+ * has no isomorphic partner.
+ ------------------------------------------------------------*/
+static void match_groups(match_data *md)
+  { ComponentSet *set1=md->set1, *set2=md->set2;
+    std::vector<node_id> lc1, lc2;
+    std::vector<bool> used;
+    int gr;
+
+    while (!md->failed &&
+           (gr=md->next_group++) < (int)md->group.size()-1)
+      { int begin=md->group[gr], end=md->group[gr+1];
+        used.assign(end-begin, false);
+        int i, j, k;
+        for(i=begin; i<end && !md->failed; i++)
+          { int k1=set1->order[i];
+            int size=set1->Size(k1);
+            lc1.resize(size);
+            lc2.resize(size);
+            bool paired=false;
+            for(j=begin; j<end && !paired; j++)
+              { if (used[j-begin])
+                  continue;
+                int k2=set2->order[j];
+                State *s=md->make_state(set1->graphs[k1],
+                                        set2->graphs[k2]);
+                int nm;
+                if (match(s, &nm, &lc1[0], &lc2[0]))
+                  { paired=true;
+                    used[j-begin]=true;
+                    node_id *c1=md->c1+set1->start[k1];
+                    node_id *c2=md->c2+set1->start[k1];
+                    for(k=0; k<nm; k++)
+                      { c1[k]=set1->nodes[set1->start[k1]+lc1[k]];
+                        c2[k]=set2->nodes[set2->start[k2]+lc2[k]];
+                      }
+                  }
+                delete s;
+              }
+            if (!paired)
+              md->failed=true;
+          }
+      }
+  }
+
+
+/*----------------------------------------------------------
+ * Comparison of the components by key, for Extract
+ ---------------------------------------------------------*/
+struct component_key_less
+  { const std::vector<graph_index_key> *keys;
+    component_key_less(const std::vector<graph_index_key> *keys)
+      { this->keys=keys; }
+    bool operator()(int a, int b) const
+      { return (*keys)[a]<(*keys)[b];
+      }
+  };
+
+
+/*----------------------------------------------------------
+ * ComponentSet::ComponentSet(g)
+ * Finds the components of g, and lists their nodes.
+ ---------------------------------------------------------*/
+ComponentSet::ComponentSet(Graph *g)
+  { this->g=g;
+    int n=g->NodeCount();
+    int i, k;
+
+    comp.resize(n);
+    count=n>0? WeakComponents(g, &comp[0]): 0;
+
+    start.assign(count+1, 0);
+    for(i=0; i<n; i++)
+      start[comp[i]+1]++;
+    for(k=0; k<count; k++)
+      start[k+1]+=start[k];
+    std::vector<int> pos(start.begin(), start.end()-1);
+    nodes.resize(n);
+    for(i=0; i<n; i++)
+      nodes[pos[comp[i]]++]=i;
+  }
+
+
+/*----------------------------------------------------------
+ * ComponentSet::~ComponentSet()
+ * Destructor.
+ ---------------------------------------------------------*/
+ComponentSet::~ComponentSet()
+  { int k;
+    for(k=0; k<(int)graphs.size(); k++)
+      delete graphs[k];
+  }
+
+
+/*----------------------------------------------------------
+ * void ComponentSet::Extract(cmp)
+ * Builds a graph for each component, computes their keys
+ * and sorts them. The graphs use the comparators of cmp.
+ ---------------------------------------------------------*/
+void ComponentSet::Extract(Graph *cmp)
+  { int n=g->NodeCount();
+    std::vector<node_id> local(n);
+    int i, j, k;
+    for(k=0; k<count; k++)
+      for(i=start[k]; i<start[k+1]; i++)
+        local[nodes[i]]=i-start[k];
+
+    graphs.resize(count);
+    keys.resize(count);
+    order.resize(count);
+    for(k=0; k<count; k++)
+      { ARGEdit ed;
+        for(i=start[k]; i<start[k+1]; i++)
+          ed.InsertNode(g->GetNodeAttr(nodes[i]));
+        for(i=start[k]; i<start[k+1]; i++)
+          { node_id u=nodes[i];
+            for(j=0; j<g->OutEdgeCount(u); j++)
+              { void *attr;
+                node_id w=g->GetOutEdge(u, j, &attr);
+                ed.InsertEdge(local[u], local[w], attr);
+              }
+          }
+        graphs[k]=new Graph(&ed);
+        if (!graphs[k])
+          error("Out of memory");
+        graphs[k]->SetNodeComparator(new ForwardComparator(cmp, false));
+        graphs[k]->SetEdgeComparator(new ForwardComparator(cmp, true));
+        ComputeIndexKey(graphs[k], &keys[k]);
+        order[k]=k;
+      }
+    std::sort(order.begin(), order.end(), component_key_less(&keys));
+  }
@@ -0,0 +1,289 @@
+/*------------------------------------------------------------------
+ * csrgraph.cc
+ * Implementation of the CSR graph files
+ *-----------------------------------------------------------------*/
+
+
+/*-----------------------------------------------------------------
+ *   IMPLEMENTATION NOTES
+ * The graph returned by MapCSRGraph is a CSRGraph, which passes
+ * to ARGraph_impl pointers into the mapped file. The mapping is
+ * held by a base class built before, and destroyed after, the
+ * ARGraph_impl part, since the destructor of ARGraph_impl still
+ * reads the offsets.
+ *
+ * The mapping is read only: ARGraph_impl never writes into the
+ * vectors of the edges, and the attributes it may allocate later
+ * are separate vectors.
+ *
+ * The checksum is computed on 64 bit words (the vectors are
+ * padded to 8 bytes), with the FNV-1a scheme applied to words
+ * instead of bytes.
+ *-----------------------------------------------------------------*/
+
+
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fstream>
+#include <vector>
+
+#include "csrgraph.h"
+#include "argloader.h"
+#include "zstream.h"
+#include "error.h"
+
+
+typedef unsigned long long uint64;
+
+static_assert(sizeof(int)==4, "the offsets of the CSR files are 32 bit ints");
+
+static const char CSR_MAGIC[8]={ 'V','F','C','S','R','G','0','1' };
+
+
+/*----------------------------------------------------------
+ * struct csr_layout
+ * The positions of the vectors in a CSR file
+ ---------------------------------------------------------*/
+struct csr_layout
+  { size_t out_start, in_start, out_node, in_node, out_rev, end;
+  };
+
+static inline size_t padded(size_t len)
+  { return (len+7) & ~(size_t)7;
+  }
+
+static void csr_layout_of(uint64 n, uint64 m, csr_layout *l)
+  { l->out_start=sizeof(csr_file_header);
+    l->in_start=l->out_start+padded((n+1)*sizeof(int));
+    l->out_node=l->in_start+padded((n+1)*sizeof(int));
+    l->in_node=l->out_node+padded(m*sizeof(node_id));
+    l->out_rev=l->in_node+padded(m*sizeof(node_id));
+    l->end=l->out_rev+padded(m*sizeof(int));
+  }
+
+static uint64 csr_checksum(const char *p, size_t len)
+  { const uint64 *w=(const uint64*)p;
+    uint64 h=0xcbf29ce484222325ULL;
+    size_t i;
+    for(i=0; i<len/8; i++)
+      h=(h^w[i])*0x100000001b3ULL;
+    return h;
+  }
+
+
+/*----------------------------------------------------------
+ * Checks the structure of a CSR file: the offsets must not
+ * decrease, the node ids must be less than n, the list of
+ * each node must be strictly increasing (FindEdge uses a
+ * binary search), each out edge i -> w must refer to the in
+ * edge of w coming from i, and undirected must be true
+ * exactly when the in and out lists of each node are equal.
+ ---------------------------------------------------------*/
+static bool csr_valid(void *addr, const csr_layout &l, uint64 n,
+                      bool undirected)
+  { const int *out_start=(const int*)((char*)addr+l.out_start);
+    const int *in_start=(const int*)((char*)addr+l.in_start);
+    const node_id *out_node=(const node_id*)((char*)addr+l.out_node);
+    const node_id *in_node=(const node_id*)((char*)addr+l.in_node);
+    const int *out_rev=(const int*)((char*)addr+l.out_rev);
+    uint64 i;
+    int k;
+    for(i=0; i<n; i++)
+      if (out_start[i+1]<out_start[i] || in_start[i+1]<in_start[i])
+        return false;
+    for(i=0; i<n; i++)
+      for(k=in_start[i]; k<in_start[i+1]; k++)
+        if (in_node[k]>=n || (k>in_start[i] && in_node[k-1]>=in_node[k]))
+          return false;
+    for(i=0; i<n; i++)
+      for(k=out_start[i]; k<out_start[i+1]; k++)
+        { node_id w=out_node[k];
+          if (w>=n || (k>out_start[i] && out_node[k-1]>=w) ||
+              out_rev[k]<in_start[w] || out_rev[k]>=in_start[w+1] ||
+              in_node[out_rev[k]]!=i)
+            return false;
+        }
+
+    bool symmetric=true;
+    for(i=0; i<n && symmetric; i++)
+      { if (in_start[i+1]!=out_start[i+1])
+          symmetric=false;
+        for(k=out_start[i]; k<out_start[i+1] && symmetric; k++)
+          if (in_node[k]!=out_node[k])
+            symmetric=false;
+      }
+    return symmetric==undirected;
+  }
+
+
+/*----------------------------------------------------------
+ * class CSRMapping
+ * Holds a mapped file, so that it is released after the
+ * ARGraph_impl part of a CSRGraph
+ ---------------------------------------------------------*/
+class CSRMapping
+  { protected:
+      void *map_addr;
+      size_t map_len;
+      CSRMapping(void *addr, size_t len) { map_addr=addr; map_len=len; }
+      ~CSRMapping() { munmap(map_addr, map_len); }
+  };
+
+
+/*----------------------------------------------------------
+ * class CSRGraph
+ * A graph over the vectors of a mapped CSR file
+ ---------------------------------------------------------*/
+class CSRGraph: private CSRMapping, public ARGraph_impl
+  { public:
+      CSRGraph(void *addr, size_t len, const csr_layout &l,
+               int n, bool undirected)
+        : CSRMapping(addr, len),
+          ARGraph_impl(n, (int*)((char*)addr+l.out_start),
+                       (node_id*)((char*)addr+l.out_node),
+                       (int*)((char*)addr+l.in_start),
+                       (node_id*)((char*)addr+l.in_node),
+                       (int*)((char*)addr+l.out_rev),
+                       undirected)
+        {}
+  };
+
+
+/*----------------------------------------------------------
+ * bool WriteCSRGraph(path, g)
+ * Writes the structure of g to a CSR file. Returns false if
+ * the file cannot be written.
+ ---------------------------------------------------------*/
+bool WriteCSRGraph(const char *path, Graph *g)
+  { uint64 n=g->NodeCount(), m=0;
+    node_id i;
+    int j;
+    for(i=0; i<n; i++)
+      m+=g->OutEdgeCount(i);
+
+    csr_layout l;
+    csr_layout_of(n, m, &l);
+    std::vector<uint64> buf((l.end-l.out_start)/8, 0);
+    char *data=(char*)&buf[0];    // The file from l.out_start on
+    int *out_start=(int*)data;
+    int *in_start=(int*)(data+l.in_start-l.out_start);
+    node_id *out_node=(node_id*)(data+l.out_node-l.out_start);
+    node_id *in_node=(node_id*)(data+l.in_node-l.out_start);
+    int *out_rev=(int*)(data+l.out_rev-l.out_start);
+
+    out_start[0]=in_start[0]=0;
+    for(i=0; i<n; i++)
+      { out_start[i+1]=out_start[i]+g->OutEdgeCount(i);
+        in_start[i+1]=in_start[i]+g->InEdgeCount(i);
+        for(j=0; j<g->InEdgeCount(i); j++)
+          in_node[in_start[i]+j]=g->GetInEdge(i, j);
+      }
+    for(i=0; i<n; i++)
+      for(j=0; j<g->OutEdgeCount(i); j++)
+        { node_id w=g->GetOutEdge(i, j);
+          int k=out_start[i]+j;
+          out_node[k]=w;
+          out_rev[k]=in_start[w]+g->GetReverseSlot(g->FindEdge(i, w));
+        }
+
+    csr_file_header h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, CSR_MAGIC, sizeof(h.magic));
+    h.byte_order=CSR_BYTE_ORDER;
+    h.node_id_size=sizeof(node_id);
+    h.flags=g->IsUndirected()? CSR_UNDIRECTED: 0;
+    h.nodes=n;
+    h.edges=m;
+    h.checksum=csr_checksum(data, buf.size()*8);
+
+    FILE *f=fopen(path, "wb");
+    if (!f)
+      return false;
+    bool ok=fwrite(&h, sizeof(h), 1, f)==1 &&
+            fwrite(&buf[0], 8, buf.size(), f)==buf.size();
+    if (fclose(f)!=0)
+      ok=false;
+    return ok;
+  }
+
+
+/*----------------------------------------------------------
+ * Graph *MapCSRGraph(path, verify)
+ * Maps a CSR file in memory, and returns a graph over it
+ * (to be deleted by the caller). If verify is true, the
+ * checksum and the structure of the file are tested.
+ * Returns NULL if the file cannot be read or is not a valid
+ * CSR file.
+ ---------------------------------------------------------*/
+Graph *MapCSRGraph(const char *path, bool verify)
+  { int fd=open(path, O_RDONLY);
+    if (fd<0)
+      return NULL;
+    struct stat st;
+    if (fstat(fd, &st)!=0 || (size_t)st.st_size<sizeof(csr_file_header))
+      { close(fd);
+        return NULL;
+      }
+    size_t len=st.st_size;
+    void *addr=mmap(NULL, len, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr==MAP_FAILED)
+      return NULL;
+
+    const csr_file_header *h=(const csr_file_header*)addr;
+    csr_layout l;
+    bool ok=memcmp(h->magic, CSR_MAGIC, sizeof(h->magic))==0 &&
+            h->byte_order==CSR_BYTE_ORDER &&
+            h->node_id_size==sizeof(node_id) &&
+            h->nodes<=NULL_NODE && h->edges<=INT_MAX;
+    if (ok)
+      { csr_layout_of(h->nodes, h->edges, &l);
+        ok=l.end==len;
+      }
+    if (ok)
+      { const int *out_start=(const int*)((char*)addr+l.out_start);
+        const int *in_start=(const int*)((char*)addr+l.in_start);
+        ok=out_start[0]==0 && in_start[0]==0 &&
+           (uint64)out_start[h->nodes]==h->edges &&
+           (uint64)in_start[h->nodes]==h->edges;
+      }
+    if (ok && verify)
+      ok=csr_checksum((char*)addr+l.out_start, l.end-l.out_start)==
+         h->checksum &&
+         csr_valid(addr, l, h->nodes, (h->flags & CSR_UNDIRECTED)!=0);
+    if (!ok)
+      { munmap(addr, len);
+        return NULL;
+      }
+
+    Graph *g=new CSRGraph(addr, len, l, (int)h->nodes,
+                          (h->flags & CSR_UNDIRECTED)!=0);
+    if (!g)
+      error("Out of memory");
+    return g;
+  }
+
+
+/*----------------------------------------------------------
+ * bool ConvertBinaryGraph(bin_path, csr_path, word_size)
+ * Converts a file in the format of BinaryGraphLoader, with
+ * words of word_size bytes and possibly compressed, into a
+ * CSR file. Returns false if a file cannot be opened or
+ * written.
+ ---------------------------------------------------------*/
+bool ConvertBinaryGraph(const char *bin_path, const char *csr_path,
+                        int word_size)
+  { std::ifstream f(bin_path, std::ios::in|std::ios::binary);
+    if (!f)
+      return false;
+    DecompressStream in(f);
+    BinaryGraphLoader loader(in, word_size);
+    Graph g(&loader);
+    return WriteCSRGraph(csr_path, &g);
+  }
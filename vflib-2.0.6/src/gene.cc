@@ -29,7 +29,7 @@ void Generate(int nodes, int edges, Graph **g1, Graph **g2,
   { 
     int i, j, n1, n2;
     byte **mat;
-    short *s;
+    node_id *s;
 
     assert(nodes>0);
     assert(edges>=0 && edges<=nodes*(nodes-1));
@@ -37,7 +37,7 @@ void Generate(int nodes, int edges, Graph **g1, Graph **g2,
     mat=new byte*[nodes];
     for(i=0; i<nodes; i++)
       mat[i]=new byte[nodes];
-    s=new short[nodes];
+    s=new node_id[nodes];
      
 
     for(i=0; i<nodes; i++)
@@ -0,0 +1,562 @@
+/*------------------------------------------------------------------
+ * graphindex.cc
+ * Implementation of the class GraphIndex
+ *-----------------------------------------------------------------*/
+
+
+/*-----------------------------------------------------------------
+ *   IMPLEMENTATION NOTES
+ * A graph is stored in the data area as in the files read by
+ * BinaryGraphLoader: the number of nodes, then for each node
+ * the number of out edges followed by their destinations.
+ *
+ * The file written by Save contains:
+ *   - a header (file_header) with a magic string, the number
+ *     of graphs, the size of node_id and the size of the data
+ *     area;
+ *   - the entries, in the order of the ids;
+ *   - the ids sorted by key, padded to a multiple of 8 bytes;
+ *   - the data area.
+ * The file is read in the byte order of the machine that
+ * wrote it; a file written with a different size of node_id
+ * is refused.
+ *
+ * The distance profiles are computed with a breadth-first
+ * visit from each node, so the key of a graph with n nodes
+ * and e edges costs O(n(n+e)), once for each graph added
+ * and once for each query. The classes are then refined in
+ * rounds costing O(n log n + e) each, at most n of them.
+ *-----------------------------------------------------------------*/
+
+
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <algorithm>
+
+#include "graphindex.h"
+#include "argedit.h"
+#include "my_vf2_state.h"
+#include "hashmix.h"
+#include "error.h"
+
+
+typedef unsigned long long uint64;
+
+static const char GRAPH_INDEX_MAGIC[8]={ 'V','F','G','I','D','X','0','2' };
+
+struct file_header
+  { char magic[8];
+    uint32_t count;
+    uint32_t node_id_size;
+    uint64_t data_len;
+  };
+
+
+/*----------------------------------------------------------
+ * Hash of a sorted vector
+ ---------------------------------------------------------*/
+static uint64 hashVector(const std::vector<uint64> &v)
+  { uint64 h=hash_mix(v.size());
+    size_t i;
+    for(i=0; i<v.size(); i++)
+      h=hash_mix(h^v[i]);
+    return h;
+  }
+
+/*----------------------------------------------------------
+ * Hash of the number of nodes at each distance from v,
+ * following the out edges (out==true) or the in edges.
+ * dist must be filled with -1, and is restored on exit.
+ ---------------------------------------------------------*/
+static uint64 distanceProfile(Graph *g, node_id v, bool out,
+                              int dist[], node_id queue[])
+  { int head=0, tail=0;
+    int level=0, level_count=0;
+    uint64 h=hash_mix(out? 1: 2);
+
+    dist[v]=0;
+    queue[tail++]=v;
+    while (head<tail)
+      { node_id u=queue[head++];
+        if (dist[u]>level)
+          { h=hash_mix(h^(uint64)level_count);
+            level=dist[u];
+            level_count=0;
+          }
+        level_count++;
+        int deg=out? g->OutEdgeCount(u): g->InEdgeCount(u);
+        int i;
+        for(i=0; i<deg; i++)
+          { node_id w=out? g->GetOutEdge(u, i): g->GetInEdge(u, i);
+            if (dist[w]<0)
+              { dist[w]=dist[u]+1;
+                queue[tail++]=w;
+              }
+          }
+      }
+    h=hash_mix(h^(uint64)level_count);
+
+    int i;
+    for(i=0; i<tail; i++)
+      dist[queue[i]]=-1;
+    return h;
+  }
+
+
+/*----------------------------------------------------------
+ * Number of distinct values in v
+ ---------------------------------------------------------*/
+static int countDistinct(const std::vector<uint64> &v)
+  { std::vector<uint64> s(v);
+    std::sort(s.begin(), s.end());
+    return std::unique(s.begin(), s.end())-s.begin();
+  }
+
+/*----------------------------------------------------------
+ * Refines the classes of the nodes given by colour: each
+ * round gives to each node a hash of its colour and of the
+ * multisets of the colours of its out and in neighbours,
+ * until the number of classes no longer grows. On exit
+ * colour holds the stable partition.
+ ---------------------------------------------------------*/
+static void refineClasses(Graph *g, std::vector<uint64> &colour)
+  { int n=colour.size();
+    int classes=countDistinct(colour);
+    std::vector<uint64> next(n);
+    int i, j;
+    while (classes<n)
+      { for(i=0; i<n; i++)
+          { uint64 out=0, in=0;
+            for(j=0; j<g->OutEdgeCount(i); j++)
+              out+=hash_mix(colour[g->GetOutEdge(i, j)]);
+            for(j=0; j<g->InEdgeCount(i); j++)
+              in+=hash_mix(colour[g->GetInEdge(i, j)]^0x696eULL);
+            next[i]=hash_mix(hash_mix(colour[i]^out)^in);
+          }
+        int c=countDistinct(next);
+        if (c==classes)
+          break;
+        classes=c;
+        colour.swap(next);
+      }
+  }
+
+
+/*----------------------------------------------------------
+ * Checks the contents of an index file: order must be a
+ * permutation of the ids sorted by key, and the data of
+ * each entry must start within the data area. If walk is
+ * true, the graph of each entry must also lie within the
+ * data area, with destinations less than its number of
+ * nodes, and with the numbers of nodes and edges of its key.
+ ---------------------------------------------------------*/
+static bool index_valid(const graph_index_entry *entries,
+                        const uint32_t *order, uint32_t count,
+                        const node_id *data, uint64 data_len, bool walk)
+  { std::vector<bool> seen(count, false);
+    uint32_t i;
+    for(i=0; i<count; i++)
+      { uint32_t id=order[i];
+        if (id>=count || seen[id])
+          return false;
+        seen[id]=true;
+        if (i>0 && entries[id].key<entries[order[i-1]].key)
+          return false;
+      }
+
+    for(i=0; i<count; i++)
+      { uint64 pos=entries[i].data;
+        if (pos>=data_len)
+          return false;
+        if (!walk)
+          continue;
+        uint64 n=data[pos++], edges=0, v, j;
+        if (n!=entries[i].key.nodes)
+          return false;
+        for(v=0; v<n; v++)
+          { if (pos>=data_len)
+              return false;
+            uint64 deg=data[pos++];
+            if (deg>data_len-pos)
+              return false;
+            for(j=0; j<deg; j++)
+              if (data[pos++]>=n)
+                return false;
+            edges+=deg;
+          }
+        if (edges!=entries[i].key.edges)
+          return false;
+      }
+    return true;
+  }
+
+
+/*----------------------------------------------------------
+ * void ComputeIndexKey(g, key)
+ * Computes the invariants of g used by GraphIndex.
+ ---------------------------------------------------------*/
+void ComputeIndexKey(Graph *g, graph_index_key *key)
+  { int n=g->NodeCount();
+    int i;
+
+    std::vector<uint64> degrees(n), profiles(n);
+    int edges=0;
+    for(i=0; i<n; i++)
+      { degrees[i]=((uint64)g->OutEdgeCount(i)<<32) | g->InEdgeCount(i);
+        edges+=g->OutEdgeCount(i);
+      }
+
+    int *dist=new int[n];
+    node_id *queue=new node_id[n];
+    if (n>0 && (!dist || !queue))
+      error("Out of memory");
+    for(i=0; i<n; i++)
+      dist[i]=-1;
+    for(i=0; i<n; i++)
+      profiles[i]=hash_mix(distanceProfile(g, i, true, dist, queue)) ^
+                  distanceProfile(g, i, false, dist, queue);
+    delete[] dist;
+    delete[] queue;
+
+    std::vector<uint64> classes(profiles);
+    refineClasses(g, classes);
+
+    std::sort(degrees.begin(), degrees.end());
+    std::sort(profiles.begin(), profiles.end());
+    std::sort(classes.begin(), classes.end());
+
+    key->nodes=n;
+    key->edges=edges;
+    key->degree_hash=hashVector(degrees);
+    key->profile_hash=hashVector(profiles);
+    key->class_hash=hashVector(classes);
+  }
+
+
+/*----------------------------------------------------------
+ * GraphIndex::GraphIndex()
+ * Constructor. Creates an empty index.
+ ---------------------------------------------------------*/
+GraphIndex::GraphIndex()
+  { sorted=true;
+    map_addr=NULL;
+    map_len=0;
+    map_entries=NULL;
+    map_order=NULL;
+    map_data=NULL;
+    map_count=0;
+  }
+
+
+/*----------------------------------------------------------
+ * GraphIndex::~GraphIndex()
+ * Destructor.
+ ---------------------------------------------------------*/
+GraphIndex::~GraphIndex()
+  { unmap();
+  }
+
+
+/*----------------------------------------------------------
+ * int GraphIndex::Add(g)
+ * Adds the structure of g to the index, and returns its id.
+ * The ids are assigned consecutively starting from 0.
+ ---------------------------------------------------------*/
+int GraphIndex::Add(Graph *g)
+  { if (map_addr)
+      copyMapped();
+
+    graph_index_entry e;
+    ComputeIndexKey(g, &e.key);
+    e.data=data.size();
+
+    int n=g->NodeCount();
+    int i, j;
+    data.push_back(n);
+    for(i=0; i<n; i++)
+      { int deg=g->OutEdgeCount(i);
+        data.push_back(deg);
+        for(j=0; j<deg; j++)
+          data.push_back(g->GetOutEdge(i, j));
+      }
+
+    entries.push_back(e);
+    order.push_back(entries.size()-1);
+    sorted=false;
+    return entries.size()-1;
+  }
+
+
+/*----------------------------------------------------------
+ * void GraphIndex::findKey(key, first, last)
+ * Finds by binary search the range [first, last) of the
+ * positions in the sorted order having the given key.
+ ---------------------------------------------------------*/
+void GraphIndex::findKey(const graph_index_key *key, int *first, int *last)
+  { sort();
+
+    int lo=0, hi=count();
+    while (lo<hi)
+      { int mid=lo+(hi-lo)/2;
+        if (entry(sortedId(mid))->key < *key)
+          lo=mid+1;
+        else
+          hi=mid;
+      }
+    *first=lo;
+    while (lo<count() && entry(sortedId(lo))->key == *key)
+      lo++;
+    *last=lo;
+  }
+
+
+/*----------------------------------------------------------
+ * int GraphIndex::Candidates(g, ids, max_ids)
+ * Finds the graphs having the same key as g, that is the
+ * only ones that can be isomorphic to g. Returns their
+ * number, and puts in ids the first max_ids of them, in
+ * increasing order.
+ ---------------------------------------------------------*/
+int GraphIndex::Candidates(Graph *g, int ids[], int max_ids)
+  { graph_index_key key;
+    int first, last;
+    ComputeIndexKey(g, &key);
+    findKey(&key, &first, &last);
+
+    int i, k=0;
+    for(i=first; i<last && k<max_ids; i++)
+      ids[k++]=sortedId(i);
+    std::sort(ids, ids+k);
+    return last-first;
+  }
+
+
+/*----------------------------------------------------------
+ * int GraphIndex::Find(g, ids, max_ids)
+ * Finds the graphs isomorphic to g, checking the candidates
+ * with MyVF2Batch. Returns their number, and puts in ids the
+ * first max_ids of them, in increasing order.
+ * Only the structure is compared: the comparators of g, if
+ * any, receive NULL as the attributes of the stored graphs.
+ ---------------------------------------------------------*/
+int GraphIndex::Find(Graph *g, int ids[], int max_ids)
+  { graph_index_key key;
+    int first, last;
+    ComputeIndexKey(g, &key);
+    findKey(&key, &first, &last);
+    if (first==last)
+      return 0;
+
+    int n=g->NodeCount();
+    node_id *c1=new node_id[n+1];
+    node_id *c2=new node_id[n+1];
+    if (!c1 || !c2)
+      error("Out of memory");
+
+    MyVF2Query query(g);
+    MyVF2Batch batch(&query);
+    int i, k=0, nm;
+    for(i=first; i<last; i++)
+      { Graph *h=GetGraph(sortedId(i));
+        if (batch.Match(h, &nm, c1, c2))
+          { if (k<max_ids)
+              ids[k]=sortedId(i);
+            k++;
+          }
+        delete h;
+      }
+    std::sort(ids, ids+std::min(k, max_ids));
+
+    delete[] c1;
+    delete[] c2;
+    return k;
+  }
+
+
+/*----------------------------------------------------------
+ * Graph* GraphIndex::GetGraph(id)
+ * Builds (using new) a graph with the structure of the
+ * graph stored with the given id, with NULL attributes.
+ ---------------------------------------------------------*/
+Graph* GraphIndex::GetGraph(int id)
+  { if (id<0 || id>=count())
+      error("GraphIndex::GetGraph: bad id %d", id);
+
+    const node_id *p=graphData(id);
+    ARGEdit ed;
+    int n=*p++;
+    int i, j;
+    for(i=0; i<n; i++)
+      ed.InsertNode(NULL);
+    for(i=0; i<n; i++)
+      { int deg=*p++;
+        for(j=0; j<deg; j++)
+          ed.InsertEdge(i, *p++, NULL);
+      }
+
+    Graph *g=new Graph(&ed);
+    if (!g)
+      error("Out of memory");
+    return g;
+  }
+
+
+/*----------------------------------------------------------
+ * bool GraphIndex::Save(path)
+ * Writes the index to a file. Returns false if the file
+ * cannot be written.
+ ---------------------------------------------------------*/
+bool GraphIndex::Save(const char *path)
+  { sort();
+
+    file_header h;
+    memcpy(h.magic, GRAPH_INDEX_MAGIC, sizeof(h.magic));
+    h.count=count();
+    h.node_id_size=sizeof(node_id);
+    h.data_len=map_addr? (uint64_t)(map_len-((const char*)map_data-
+                                    (const char*)map_addr))/sizeof(node_id)
+                       : data.size();
+
+    FILE *f=fopen(path, "wb");
+    if (!f)
+      return false;
+
+    static const char pad[8]={ 0 };
+    size_t order_len=h.count*sizeof(uint32_t);
+    bool ok=fwrite(&h, sizeof(h), 1, f)==1;
+    if (ok && h.count>0)
+      { const graph_index_entry *pe=map_addr? map_entries: &entries[0];
+        const uint32_t *po=map_addr? map_order: &order[0];
+        const node_id *pd=map_addr? map_data: &data[0];
+        ok=fwrite(pe, sizeof(*pe), h.count, f)==h.count &&
+           fwrite(po, sizeof(*po), h.count, f)==h.count &&
+           fwrite(pad, 1, (8-order_len%8)%8, f)==(8-order_len%8)%8 &&
+           fwrite(pd, sizeof(*pd), h.data_len, f)==h.data_len;
+      }
+    if (fclose(f)!=0)
+      ok=false;
+    return ok;
+  }
+
+
+/*----------------------------------------------------------
+ * bool GraphIndex::Load(path, verify)
+ * Replaces the contents of the index with the ones of a
+ * file written by Save, mapping the file in memory.
+ * Returns false (leaving the index empty) if the file cannot
+ * be read or is not a valid index. The header, the entries
+ * and the order of the ids are always checked; the graphs
+ * are checked only if verify is true, since this reads the
+ * whole data area, and otherwise they are trusted.
+ ---------------------------------------------------------*/
+bool GraphIndex::Load(const char *path, bool verify)
+  { unmap();
+    entries.clear();
+    order.clear();
+    data.clear();
+    sorted=true;
+
+    int fd=open(path, O_RDONLY);
+    if (fd<0)
+      return false;
+    struct stat st;
+    if (fstat(fd, &st)!=0 || (size_t)st.st_size<sizeof(file_header))
+      { close(fd);
+        return false;
+      }
+    size_t len=st.st_size;
+    void *addr=mmap(NULL, len, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr==MAP_FAILED)
+      return false;
+
+    const file_header *h=(const file_header*)addr;
+    size_t order_len=h->count*(size_t)sizeof(uint32_t);
+    size_t data_pos=sizeof(file_header)+
+                    h->count*(size_t)sizeof(graph_index_entry)+
+                    order_len+(8-order_len%8)%8;
+    if (memcmp(h->magic, GRAPH_INDEX_MAGIC, sizeof(h->magic))!=0 ||
+        h->node_id_size!=sizeof(node_id) ||
+        data_pos>len ||
+        h->data_len!=(len-data_pos)/sizeof(node_id))
+      { munmap(addr, len);
+        return false;
+      }
+
+    const graph_index_entry *pe=(const graph_index_entry*)(h+1);
+    const uint32_t *po=(const uint32_t*)(pe+h->count);
+    const node_id *pd=(const node_id*)((const char*)addr+data_pos);
+    if (!index_valid(pe, po, h->count, pd, h->data_len, verify))
+      { munmap(addr, len);
+        return false;
+      }
+
+    map_addr=addr;
+    map_len=len;
+    map_count=h->count;
+    map_entries=pe;
+    map_order=po;
+    map_data=pd;
+    return true;
+  }
+
+
+/*----------------------------------------------------------
+ * void GraphIndex::unmap()
+ * Releases the mapped file, if any.
+ ---------------------------------------------------------*/
+void GraphIndex::unmap()
+  { if (map_addr)
+      munmap(map_addr, map_len);
+    map_addr=NULL;
+    map_len=0;
+    map_entries=NULL;
+    map_order=NULL;
+    map_data=NULL;
+    map_count=0;
+  }
+
+
+/*----------------------------------------------------------
+ * void GraphIndex::copyMapped()
+ * Copies the contents of the mapped file in memory, so that
+ * new graphs can be added.
+ ---------------------------------------------------------*/
+void GraphIndex::copyMapped()
+  { size_t data_len=(map_len-((const char*)map_data-
+                              (const char*)map_addr))/sizeof(node_id);
+    entries.assign(map_entries, map_entries+map_count);
+    order.assign(map_order, map_order+map_count);
+    data.assign(map_data, map_data+data_len);
+    unmap();
+    sorted=true;
+  }
+
+
+/*----------------------------------------------------------
+ * Comparison of the ids by key, for sort()
+ ---------------------------------------------------------*/
+struct id_key_less
+  { const graph_index_entry *e;
+    id_key_less(const graph_index_entry *e) { this->e=e; }
+    bool operator()(uint32_t a, uint32_t b) const
+      { return e[a].key<e[b].key || (e[a].key==e[b].key && a<b);
+      }
+  };
+
+/*----------------------------------------------------------
+ * void GraphIndex::sort()
+ * Sorts the ids by key, if graphs have been added.
+ ---------------------------------------------------------*/
+void GraphIndex::sort()
+  { if (sorted || map_addr)
+      return;
+    if (!entries.empty())
+      std::sort(order.begin(), order.end(), id_key_less(&entries[0]));
+    sorted=true;
+  }
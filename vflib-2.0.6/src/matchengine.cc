@@ -0,0 +1,137 @@
+/*------------------------------------------------------------------
+ * matchengine.cc
+ * Implementation of the class MatchEngine
+ *-----------------------------------------------------------------*/
+
+
+/*-----------------------------------------------------------------
+ *   IMPLEMENTATION NOTES
+ * stack[0] holds the initial state, which is not deleted and
+ * not backtracked, as in the match functions; the other frames
+ * hold the states built with Clone, which are backtracked and
+ * deleted when popped. top is the index of the current frame,
+ * or -1 when the search is over.
+ * Each state adds one pair to its parent, so the depth never
+ * exceeds the number of nodes of g1; the vector is enlarged
+ * anyway if a state breaks this assumption.
+ *-----------------------------------------------------------------*/
+
+
+#include <stddef.h>
+
+#include "matchengine.h"
+#include "error.h"
+
+
+/*----------------------------------------------------------
+ * MatchEngine::MatchEngine(s0)
+ * Constructor. Prepares the search from state s0.
+ ---------------------------------------------------------*/
+MatchEngine::MatchEngine(State *s0)
+  { stack_size=s0->GetGraph1()->NodeCount()+1;
+    stack=new frame[stack_size];
+    if (!stack)
+      error("Out of memory");
+    top=-1;
+    at_goal=false;
+    step_count=0;
+    push(s0);
+  }
+
+
+/*----------------------------------------------------------
+ * MatchEngine::~MatchEngine()
+ * Destructor. Deletes the states of the current path,
+ * restoring the initial state.
+ ---------------------------------------------------------*/
+MatchEngine::~MatchEngine()
+  { while (top>=0)
+      pop();
+    delete[] stack;
+  }
+
+
+/*----------------------------------------------------------
+ * int MatchEngine::Run(max_steps)
+ * Continues the search for at most max_steps steps, or
+ * without limits if max_steps is 0.
+ * Returns MATCH_FOUND, MATCH_EXHAUSTED or MATCH_SUSPENDED
+ * (see matchengine.h).
+ ---------------------------------------------------------*/
+int MatchEngine::Run(long max_steps)
+  { long steps=0;
+
+    if (at_goal)
+      { at_goal=false;
+        pop();
+      }
+
+    while (top>=0)
+      { if (max_steps>0 && steps>=max_steps)
+          return MATCH_SUSPENDED;
+        steps++;
+        step_count++;
+
+        frame *f=&stack[top];
+        if (!f->visited)
+          { f->visited=true;
+            if (f->s->IsGoal())
+              { at_goal=true;
+                return MATCH_FOUND;
+              }
+            if (f->s->IsDead())
+              { pop();
+                continue;
+              }
+          }
+
+        if (f->s->NextPair(&f->n1, &f->n2, f->n1, f->n2))
+          { if (f->s->IsFeasiblePair(f->n1, f->n2))
+              { State *s1=f->s->Clone();
+                s1->AddPair(f->n1, f->n2);
+                push(s1);
+              }
+          }
+        else
+          pop();
+      }
+
+    return MATCH_EXHAUSTED;
+  }
+
+
+/*----------------------------------------------------------
+ * void MatchEngine::push(s)
+ * Makes s the current state.
+ ---------------------------------------------------------*/
+void MatchEngine::push(State *s)
+  { if (top+1>=stack_size)
+      { int size=2*stack_size+1;
+        frame *v=new frame[size];
+        if (!v)
+          error("Out of memory");
+        int i;
+        for(i=0; i<=top; i++)
+          v[i]=stack[i];
+        delete[] stack;
+        stack=v;
+        stack_size=size;
+      }
+    top++;
+    stack[top].s=s;
+    stack[top].n1=stack[top].n2=NULL_NODE;
+    stack[top].visited=false;
+  }
+
+
+/*----------------------------------------------------------
+ * void MatchEngine::pop()
+ * Reverts to the parent of the current state.
+ ---------------------------------------------------------*/
+void MatchEngine::pop()
+  { if (top>0)
+      { stack[top].s->BackTrack();
+        delete stack[top].s;
+      }
+    top--;
+  }
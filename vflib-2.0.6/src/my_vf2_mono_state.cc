@@ -0,0 +1,136 @@
+/*------------------------------------------------------------------
+ * my_vf2_mono_state.cc
+ * Implementation of the class MyVF2MonoStaticState
+ *-----------------------------------------------------------------*/
+
+
+
+/*-----------------------------------------------------------------
+ * NOTE: 
+ *   The attribute compatibility check (methods CompatibleNode
+ *   and CompatibleEdge of ARGraph) is always performed
+ *   applying the method to g1, and passing the attribute of
+ *   g1 as first argument, and the attribute of g2 as second
+ *   argument. This may be important if the compatibility
+ *   criterion is not symmetric.
+ -----------------------------------------------------------------*/
+
+
+/*---------------------------------------------------------
+ *   DIFFERENCES FROM VF2MonoState
+ * Before the search each node receives the counts of the
+ * nodes reachable within each distance up to REACH_RADIUS
+ * (see reachcount.h). Since a monomorphism maps each path of
+ * g1 onto a path of g2, it does not increase distances, so
+ * a node of g1 can be paired only with a node of g2 having
+ * greater or equal counts; NextPair only proposes such pairs.
+ * IsFeasiblePair also requires the in/out degree of node1
+ * not to exceed the one of node2, and compares the terminal
+ * sets separately for 'in' and 'out' neighbours.
+ ---------------------------------------------------------*/
+
+
+/*---------------------------------------------------------
+ *   IMPLEMENTATION NOTES:
+ * The six vectors core_1, core_2, in_1, in_2, out_1, out_2, 
+ * are shared among the instances of this class; they are
+ * owned by the instance with core_len==0 (the root of the
+ * SSR).
+ * In the vectors in_* and out_* there is a value indicating 
+ * the level at which the corresponding node became a member
+ * of the core or of Tin (for in_*) or Tout (for out_*),
+ * or 0 if the node does not belong to the set.
+ * This information is used for backtracking.
+ * The fields t1out_len etc. also count the nodes in core.
+ * The true t1out_len is t1out_len-core_len!
+ ---------------------------------------------------------*/
+
+
+#include <stddef.h>
+
+#include "my_vf2_mono_state.h"
+
+#include "error.h"
+
+#include "sortnodes.h"
+
+
+/*----------------------------------------------------------
+ * Methods of the class MyVF2MonoStaticState
+ * Most of the methods are inline, and are defined in my_vf2_mono_state.h
+ ---------------------------------------------------------*/
+
+/*----------------------------------------------------------
+ * MyVF2MonoStaticState::MyVF2MonoStaticState(g1, g2, sortNodes)
+ * Constructor. Makes an empty state, and computes the
+ * reach counts of the nodes of the two graphs.
+ ---------------------------------------------------------*/
+MyVF2MonoStaticState::MyVF2MonoStaticState(Graph *ag1, Graph *ag2, bool sortNodes)
+  { g1=ag1;
+    g2=ag2;
+    n1=g1->NodeCount();
+    n2=g2->NodeCount();
+
+    if (sortNodes)
+      order=SortNodesByFrequency(ag1);
+    else
+      order=NULL;
+
+    core_len=orig_core_len=0;
+    t1both_len=t1in_len=t1out_len=0;
+    t2both_len=t2in_len=t2out_len=0;
+
+	added_node1=NULL_NODE;
+
+    core_1=new node_id[n1];
+    core_2=new node_id[n2];
+    in_1=new node_id[n1];
+    in_2=new node_id[n2];
+    out_1=new node_id[n1];
+    out_2=new node_id[n2];
+	share_count = new long;
+
+    if (!core_1 || !core_2 || !in_1 || !in_2 
+	    || !out_1 || !out_2 || !share_count)
+      error("Out of memory");
+
+    int i;
+    for(i=0; i<n1; i++)
+      { 
+        core_1[i]=NULL_NODE;
+		in_1[i]=0;
+		out_1[i]=0;
+		
+      }
+    for(i=0; i<n2; i++)
+      { 
+        core_2[i]=NULL_NODE;
+		in_2[i]=0;
+		out_2[i]=0;
+      }
+	
+	*share_count = 1;
+
+    if (n1<=n2)
+      { reach1=ComputeReachCounts(g1);
+        reach2=ComputeReachCounts(g2);
+      }
+    else
+      reach1=reach2=NULL;
+  }
+
+
+/*--------------------------------------------------------------
+ * void MyVF2MonoStaticState::GetCoreSet(c1, c2)
+ * Reads the core set of the state into the arrays c1 and c2.
+ * The i-th pair of the mapping is (c1[i], c2[i])
+ --------------------------------------------------------------*/
+void MyVF2MonoStaticState::GetCoreSet(node_id c1[], node_id c2[])
+  { int i,j;
+    for (i=0,j=0; i<n1; i++)
+      if (core_1[i] != NULL_NODE)
+        { c1[j]=i;
+          c2[j]=core_1[i];
+          j++;
+        }
+  }
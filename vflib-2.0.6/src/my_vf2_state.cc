@@ -0,0 +1,456 @@
+/*------------------------------------------------------------------
+ * my_vf2_state.cc
+ * Implementation of the class MyVF2StaticState (the VFD algorithm)
+ *-----------------------------------------------------------------*/
+
+
+
+/*-----------------------------------------------------------------
+ * NOTE: 
+ *   The attribute compatibility check (methods CompatibleNode
+ *   and CompatibleEdge of ARGraph) is always performed
+ *   applying the method to g1, and passing the attribute of
+ *   g1 as first argument, and the attribute of g2 as second
+ *   argument. This may be important if the compatibility
+ *   criterion is not symmetric.
+ -----------------------------------------------------------------*/
+
+
+/*---------------------------------------------------------
+ *   DIFFERENCES FROM VF2
+ * Before the search, each node receives a feature computed
+ * from the distances between the node and the other nodes
+ * of its graph (see createInitialFeatures); NextPair only
+ * proposes pairs of nodes having the same feature.
+ * IsFeasiblePair requires the two nodes to have the same
+ * in/out degree, and compares the terminal sets separately
+ * for 'in' and 'out' neighbours; thanks to these stronger
+ * conditions, IsDead only compares t1both_len and t2both_len.
+ * The features are computed only if the two graphs have
+ * the same number of nodes, since otherwise the state is
+ * dead from the start.
+ ---------------------------------------------------------*/
+
+
+/*---------------------------------------------------------
+ *   IMPLEMENTATION NOTES:
+ * The six vectors core_1, core_2, in_1, in_2, out_1, out_2, 
+ * are shared among the instances of this class; they are
+ * owned by the instance with core_len==0 (the root of the
+ * SSR).
+ * In the vectors in_* and out_* there is a value indicating 
+ * the level at which the corresponding node became a member
+ * of the core or of Tin (for in_*) or Tout (for out_*),
+ * or 0 if the node does not belong to the set.
+ * This information is used for backtracking.
+ * The fields t1out_len etc. also count the nodes in core.
+ * The true t1out_len is t1out_len-core_len!
+ * If both graphs are undirected, the in and out terminal
+ * sets are equal: in_1 and in_2 are not allocated, and only
+ * out_*, t1out_len and t2out_len are maintained. Since this
+ * mode checks the attribute of only one direction of each
+ * edge, it is not used if a graph has edge attributes.
+ ---------------------------------------------------------*/
+
+
+#include <stddef.h>
+#include <math.h>
+#include <algorithm>
+#include <queue>
+
+#include "my_vf2_state.h"
+
+#include "error.h"
+
+#include "sortnodes.h"
+#include "static_match.h"
+
+static void createInitialFeatures(Graph *g, double *features, int k);
+static bool useUndirected(Graph *g1, Graph *g2);
+static void createInitialFeaturesUtil(Graph *g, double *features, node_id *d, node_id node0, int k, int n);
+
+/*----------------------------------------------------------
+ * Methods of the class MyVF2StaticState
+ * Most of the methods are inline, and are defined in my_vf2_state.h
+ ---------------------------------------------------------*/
+
+/*----------------------------------------------------------
+ * MyVF2StaticState::MyVF2StaticState(g1, g2, sortNodes)
+ * Constructor. Makes an empty state, and computes the
+ * node features of the two graphs.
+ ---------------------------------------------------------*/
+MyVF2StaticState::MyVF2StaticState(Graph *ag1, Graph *ag2, bool sortNodes)
+  { g1=ag1;
+    g2=ag2;
+    n1=g1->NodeCount();
+    n2=g2->NodeCount();
+    undirected=useUndirected(g1, g2);
+
+    if (sortNodes)
+      order=SortNodesByFrequency(ag1);
+    else
+      order=NULL;
+
+    core_len=orig_core_len=0;
+    t1both_len=t1in_len=t1out_len=0;
+    t2both_len=t2in_len=t2out_len=0;
+
+	added_node1=NULL_NODE;
+
+    core_1=new node_id[n1];
+    core_2=new node_id[n2];
+    if (undirected)
+      in_1=in_2=NULL;
+    else
+      { in_1=new node_id[n1];
+        in_2=new node_id[n2];
+        if (!in_1 || !in_2)
+          error("Out of memory");
+      }
+    out_1=new node_id[n1];
+    out_2=new node_id[n2];
+	share_count = new long;
+
+    if (!core_1 || !core_2 || !out_1 || !out_2 || !share_count)
+      error("Out of memory");
+
+    int i;
+    for(i=0; i<n1; i++)
+      { 
+        core_1[i]=NULL_NODE;
+		out_1[i]=0;
+		
+      }
+    for(i=0; i<n2; i++)
+      { 
+        core_2[i]=NULL_NODE;
+		out_2[i]=0;
+      }
+    if (!undirected)
+      { for(i=0; i<n1; i++)
+          in_1[i]=0;
+        for(i=0; i<n2; i++)
+          in_2[i]=0;
+      }
+	
+	*share_count = 1;
+    owns_arrays=true;
+
+	if(n1==n2){
+		features1=new double[n1];
+		features2=new double[n2];
+		createInitialFeatures(g1, features1, n1);
+		createInitialFeatures(g2, features2, n2);
+	}
+	else
+	  features1=features2=NULL;
+  }
+
+
+/*----------------------------------------------------------
+ * MyVF2StaticState::MyVF2StaticState(batch, g2)
+ * Constructor. Makes an empty state for the query of batch
+ * and g2, using the features and the vectors of batch,
+ * which must have been prepared for g2 (see
+ * MyVF2Batch::prepare). The vectors belong to batch, so
+ * the state and its copies do not own them (owns_arrays is
+ * false) and do not deallocate them.
+ ---------------------------------------------------------*/
+MyVF2StaticState::MyVF2StaticState(MyVF2Batch *batch, Graph *ag2)
+  { MyVF2Query *q=batch->query;
+    g1=q->g;
+    g2=ag2;
+    n1=q->n;
+    n2=g2->NodeCount();
+    undirected=useUndirected(g1, g2);
+    order=q->order;
+
+    core_len=orig_core_len=0;
+    t1both_len=t1in_len=t1out_len=0;
+    t2both_len=t2in_len=t2out_len=0;
+
+	added_node1=NULL_NODE;
+
+    core_1=batch->core_1;
+    in_1=batch->in_1;
+    out_1=batch->out_1;
+    core_2=batch->core_2;
+    in_2=batch->in_2;
+    out_2=batch->out_2;
+    features1=q->features;
+    features2=batch->features2;
+
+    int i;
+    for(i=0; i<n1; i++)
+      { core_1[i]=NULL_NODE;
+        in_1[i]=0;
+        out_1[i]=0;
+      }
+    for(i=0; i<n2; i++)
+      { core_2[i]=NULL_NODE;
+        in_2[i]=0;
+        out_2[i]=0;
+      }
+
+    share_count=NULL;
+    owns_arrays=false;
+  }
+
+
+/*--------------------------------------------------------------
+ * void MyVF2StaticState::GetCoreSet(c1, c2)
+ * Reads the core set of the state into the arrays c1 and c2.
+ * The i-th pair of the mapping is (c1[i], c2[i])
+ --------------------------------------------------------------*/
+void MyVF2StaticState::GetCoreSet(node_id c1[], node_id c2[])
+  { int i,j;
+    for (i=0,j=0; i<n1; i++)
+      if (core_1[i] != NULL_NODE)
+        { c1[j]=i;
+          c2[j]=core_1[i];
+          j++;
+        }
+  }
+
+
+/*----------------------------------------------------------
+ * Methods of the classes MyVF2Query and MyVF2Batch
+ ---------------------------------------------------------*/
+
+/*----------------------------------------------------------
+ * MyVF2Query::MyVF2Query(g, sortNodes)
+ * Constructor. Computes the features of the nodes of g,
+ * and, if sortNodes is true, the node order.
+ ---------------------------------------------------------*/
+MyVF2Query::MyVF2Query(Graph *ag, bool sortNodes)
+  { g=ag;
+    n=g->NodeCount();
+    features=new double[n+1];
+    sorted_features=new double[n+1];
+    if (!features || !sorted_features)
+      error("Out of memory");
+
+    int i;
+    edges=0;
+    for(i=0; i<n; i++)
+      edges+=g->OutEdgeCount(i);
+
+    createInitialFeatures(g, features, n);
+    for(i=0; i<n; i++)
+      sorted_features[i]=features[i];
+    std::sort(sorted_features, sorted_features+n);
+
+    if (sortNodes)
+      order=SortNodesByFrequency(g);
+    else
+      order=NULL;
+  }
+
+
+/*----------------------------------------------------------
+ * MyVF2Query::~MyVF2Query()
+ * Destructor.
+ ---------------------------------------------------------*/
+MyVF2Query::~MyVF2Query()
+  { delete[] features;
+    delete[] sorted_features;
+    delete[] order;
+  }
+
+
+/*----------------------------------------------------------
+ * MyVF2Batch::MyVF2Batch(query)
+ * Constructor. The vectors for g1 are allocated once; the
+ * ones for the targets are enlarged when needed.
+ ---------------------------------------------------------*/
+MyVF2Batch::MyVF2Batch(MyVF2Query *q)
+  { query=q;
+    int n=q->n+1;
+    core_1=new node_id[n];
+    in_1=new node_id[n];
+    out_1=new node_id[n];
+    if (!core_1 || !in_1 || !out_1)
+      error("Out of memory");
+    size2=0;
+    core_2=in_2=out_2=NULL;
+    features2=sorted2=NULL;
+    reject_count=0;
+  }
+
+
+/*----------------------------------------------------------
+ * MyVF2Batch::~MyVF2Batch()
+ * Destructor.
+ ---------------------------------------------------------*/
+MyVF2Batch::~MyVF2Batch()
+  { delete[] core_1;
+    delete[] in_1;
+    delete[] out_1;
+    delete[] core_2;
+    delete[] in_2;
+    delete[] out_2;
+    delete[] features2;
+    delete[] sorted2;
+  }
+
+
+/*----------------------------------------------------------
+ * bool MyVF2Batch::prepare(g2)
+ * Computes the features of g2 and compares them with the
+ * ones of the query.
+ * Returns false if g2 cannot be isomorphic to the query.
+ ---------------------------------------------------------*/
+bool MyVF2Batch::prepare(Graph *g2)
+  { int n=query->n;
+    int i, edges;
+
+    if (g2->NodeCount()!=n)
+      return false;
+    for(i=0, edges=0; i<n; i++)
+      edges+=g2->OutEdgeCount(i);
+    if (edges!=query->edges)
+      return false;
+
+    if (n>size2)
+      { delete[] core_2;
+        delete[] in_2;
+        delete[] out_2;
+        delete[] features2;
+        delete[] sorted2;
+        size2=n;
+        core_2=new node_id[size2];
+        in_2=new node_id[size2];
+        out_2=new node_id[size2];
+        features2=new double[size2];
+        sorted2=new double[size2];
+        if (!core_2 || !in_2 || !out_2 || !features2 || !sorted2)
+          error("Out of memory");
+      }
+
+    createInitialFeatures(g2, features2, n);
+    for(i=0; i<n; i++)
+      sorted2[i]=features2[i];
+    std::sort(sorted2, sorted2+n);
+    for(i=0; i<n; i++)
+      if (fabs(sorted2[i]-query->sorted_features[i])>0.00000001)
+        return false;
+    return true;
+  }
+
+
+/*----------------------------------------------------------
+ * bool MyVF2Batch::Match(g2, pn, c1, c2)
+ * Finds an isomorphism between the query and g2, as
+ * match(s0, pn, c1, c2) does with a MyVF2State.
+ ---------------------------------------------------------*/
+bool MyVF2Batch::Match(Graph *g2, int *pn, node_id c1[], node_id c2[])
+  { if (!prepare(g2))
+      { reject_count++;
+        return false;
+      }
+    MyVF2StaticState s0(this, g2);
+    return match(&s0, pn, c1, c2);
+  }
+
+
+/*----------------------------------------------------------
+ * int MyVF2Batch::Match(g2, vis, usr_data)
+ * Visits all the isomorphisms between the query and g2, as
+ * match(s0, vis, usr_data) does with a MyVF2State.
+ ---------------------------------------------------------*/
+int MyVF2Batch::Match(Graph *g2, match_visitor vis, void *usr_data)
+  { if (!prepare(g2))
+      { reject_count++;
+        return 0;
+      }
+    MyVF2StaticState s0(this, g2);
+    return match(&s0, vis, usr_data);
+  }
+
+
+
+/*---------------------------------------------------------
+ * Static functions
+ --------------------------------------------------------*/
+
+/*--------------------------------------------------------
+ * Tells if the undirected mode can be used for g1 and g2:
+ * both must be undirected, and without edge attributes,
+ * since the attribute of the reverse edge is not checked.
+ -------------------------------------------------------*/
+static bool useUndirected(Graph *g1, Graph *g2)
+  { return g1->IsUndirected() && g2->IsUndirected() &&
+           !g1->HasEdgeAttrs() && !g2->HasEdgeAttrs();
+  }
+
+/*--------------------------------------------------------
+ * Computes the feature of each node of g. A BFS from each
+ * node gives its distances from the other nodes; every
+ * node at distance d contributes exp(-d/(k+k*k)) to the
+ * feature of the source and exp(-d*k/(k+k*k)) to its own
+ * feature, while unreachable nodes contribute 1.
+ -------------------------------------------------------*/
+static void createInitialFeatures(Graph *g, double *features, int k){
+	int n=g->NodeCount();
+
+    assert(n < (long long)NULL_NODE);
+
+    node_id *d;
+    d=new node_id [n];
+    for(int i=0; i<n; i++){
+        d[i]=NULL_NODE;
+        features[i] = 0;
+	}
+	
+	for(int i=0; i<n; i++){
+		createInitialFeaturesUtil(g,features, d, i, k, n);
+                for(int i=0; i<n; i++)
+                    d[i] = NULL_NODE;
+	}
+	delete [] d;
+	
+}
+
+static void createInitialFeaturesUtil(Graph *g, double *features, node_id *d, node_id node0, int k, int n){
+	std::queue<node_id > q;
+	q.push(node0);
+	d[node0]=0;
+	node_id node1,node2;
+	int edgesNum;
+	while(!q.empty()){
+		node1=q.front();
+		q.pop();
+		//knowns[node1] = true;
+		edgesNum = g->OutEdgeCount(node1);
+		for(int i=0;i<edgesNum; i++){
+			node2 = g->GetOutEdge(node1,i);
+			//if(d[node0][node2]<k){
+				if(d[node2]==NULL_NODE){
+                    d[node2] = d[node1]+1;
+                    if(d[node2]<(node_id)k)
+				      q.push(node2);
+				}
+
+
+			//}
+		}
+
+	}
+             
+        double ratio;
+        double fenmu=k+k*k;
+
+	for(int i=0; i<n; i++){
+	    if(d[i]==NULL_NODE){
+	        features[node0]+=1;
+            }
+	    else if(d[i]>0){
+	        ratio = -double(d[i])/fenmu;
+	        features[node0]+=exp(ratio);
+                ratio = -double(d[i]*k)/fenmu;
+                features[i] += exp(ratio);
+
+            }
+	}
+
+}
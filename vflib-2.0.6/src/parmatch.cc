@@ -0,0 +1,265 @@
+/*-------------------------------------------------------
+ * parmatch.cc
+ * Definition of the parallel_match function
+ ------------------------------------------------------*/
+
+
+/*-----------------------------------------------------------------
+ *   IMPLEMENTATION NOTES
+ * The field pending counts the tasks that have been created
+ * and are not completed yet; the search is over when it
+ * reaches 0, or when a matching is found.
+ * A task is completed when the worker that took it has
+ * visited the whole subtree, except the candidate pairs it
+ * has moved into its deque (which are new tasks, counted
+ * separately). A worker moves a pair only if some worker is
+ * idle and its own deque is empty, so at most one task per
+ * worker is waiting to be stolen.
+ *-----------------------------------------------------------------*/
+
+
+#include <stddef.h>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "argraph.h"
+#include "parmatch.h"
+#include "state.h"
+#include "error.h"
+
+
+struct pair_id
+  { node_id n1, n2;
+  };
+
+typedef std::vector<pair_id> task;
+
+struct worker
+  { std::mutex lock;
+    std::deque<task> tasks;
+    long state_count;
+  };
+
+struct shared_data
+  { state_factory factory;
+    void *usr_data;
+    int nthreads;
+    worker *workers;
+
+    std::atomic<bool> found;
+    std::atomic<int> pending;
+    std::atomic<int> idle;
+
+    std::mutex result_lock;
+    int *pn;
+    node_id *c1, *c2;
+  };
+
+
+static void run_worker(shared_data *sh, int id);
+static bool get_task(shared_data *sh, int id, task *t);
+static bool explore(shared_data *sh, worker *w, State *s, task *path);
+
+
+/*-------------------------------------------------------------
+ * bool parallel_match(factory, usr_data, nthreads,
+ *                     pn, c1, c2, state_count)
+ * Finds a matching between two graph, if it exists, using
+ * nthreads threads; the initial state of each thread is built
+ * by factory(usr_data).
+ * Returns true a match has been found.
+ * *pn is assigned the number of matched nodes, and
+ * c1 and c2 will contain the ids of the corresponding nodes
+ * in the two graphs.
+ * If state_count is not NULL, state_count[i] is assigned the
+ * number of states explored by the i-th thread.
+ ------------------------------------------------------------*/
+bool parallel_match(state_factory factory, void *usr_data, int nthreads,
+                    int *pn, node_id c1[], node_id c2[],
+                    long *state_count)
+  { if (nthreads<1)
+      nthreads=1;
+
+    shared_data sh;
+    sh.factory=factory;
+    sh.usr_data=usr_data;
+    sh.nthreads=nthreads;
+    sh.workers=new worker[nthreads];
+    if (!sh.workers)
+      error("Out of memory");
+    sh.found=false;
+    sh.pending=1;
+    sh.idle=0;
+    sh.pn=pn;
+    sh.c1=c1;
+    sh.c2=c2;
+
+    int i;
+    for(i=0; i<nthreads; i++)
+      sh.workers[i].state_count=0;
+    sh.workers[0].tasks.push_back(task());
+
+    std::vector<std::thread> threads;
+    for(i=1; i<nthreads; i++)
+      threads.push_back(std::thread(run_worker, &sh, i));
+    run_worker(&sh, 0);
+    for(i=0; i<(int)threads.size(); i++)
+      threads[i].join();
+
+    if (state_count!=NULL)
+      for(i=0; i<nthreads; i++)
+        state_count[i]=sh.workers[i].state_count;
+
+    delete[] sh.workers;
+    return sh.found;
+  }
+
+
+
+/*---------------------------------------------------------
+ * Static functions
+ --------------------------------------------------------*/
+
+/*-------------------------------------------------------------
+ * Body of the id-th worker: takes the tasks and explores them
+ * until the search is over.
+ ------------------------------------------------------------*/
+static void run_worker(shared_data *sh, int id)
+  { worker *w=&sh->workers[id];
+    State *s0=sh->factory(sh->usr_data);
+    std::vector<State*> chain;
+    task t;
+    int i;
+
+    while (get_task(sh, id, &t))
+      { // Rebuild the root of the subtree
+        chain.clear();
+        chain.push_back(s0);
+        for(i=0; i<(int)t.size(); i++)
+          { State *s1=chain.back()->Clone();
+            s1->AddPair(t[i].n1, t[i].n2);
+            chain.push_back(s1);
+          }
+
+        explore(sh, w, chain.back(), &t);
+
+        for(i=(int)chain.size()-1; i>0; i--)
+          { chain[i]->BackTrack();
+            delete chain[i];
+          }
+        --sh->pending;
+      }
+
+    delete s0;
+  }
+
+
+/*-------------------------------------------------------------
+ * Puts in *t the next task for the id-th worker, taken from
+ * its deque or stolen from another one, waiting while other
+ * workers may still create new tasks.
+ * Returns false when the search is over.
+ ------------------------------------------------------------*/
+static bool get_task(shared_data *sh, int id, task *t)
+  { bool is_idle=false;
+    int i;
+    for(;;)
+      { if (sh->found)
+          break;
+
+        worker *w=&sh->workers[id];
+          { std::lock_guard<std::mutex> guard(w->lock);
+            if (!w->tasks.empty())
+              { t->swap(w->tasks.back());
+                w->tasks.pop_back();
+                if (is_idle)
+                  --sh->idle;
+                return true;
+              }
+          }
+
+        for(i=1; i<sh->nthreads; i++)
+          { worker *v=&sh->workers[(id+i)%sh->nthreads];
+            std::lock_guard<std::mutex> guard(v->lock);
+            if (!v->tasks.empty())
+              { t->swap(v->tasks.front());
+                v->tasks.pop_front();
+                if (is_idle)
+                  --sh->idle;
+                return true;
+              }
+          }
+
+        if (sh->pending==0)
+          break;
+        if (!is_idle)
+          { is_idle=true;
+            ++sh->idle;
+          }
+        std::this_thread::yield();
+      }
+
+    if (is_idle)
+      --sh->idle;
+    return false;
+  }
+
+
+/*-------------------------------------------------------------
+ * Explores the subtree rooted at state s; path contains the
+ * pairs leading to s.
+ * Returns true if a match has been found, or the search
+ * must be stopped.
+ ------------------------------------------------------------*/
+static bool explore(shared_data *sh, worker *w, State *s, task *path)
+  { if (sh->found)
+      return true;
+    w->state_count++;
+
+    if (s->IsGoal())
+      { std::lock_guard<std::mutex> guard(sh->result_lock);
+        if (!sh->found)
+          { *sh->pn=s->CoreLen();
+            s->GetCoreSet(sh->c1, sh->c2);
+            sh->found=true;
+          }
+        return true;
+      }
+
+    if (s->IsDead())
+      return false;
+
+    node_id n1=NULL_NODE, n2=NULL_NODE;
+    while (s->NextPair(&n1, &n2, n1, n2))
+      { if (!s->IsFeasiblePair(n1, n2))
+          continue;
+
+        pair_id p;
+        p.n1=n1;
+        p.n2=n2;
+
+        if (sh->idle>0)
+          { std::lock_guard<std::mutex> guard(w->lock);
+            if (w->tasks.empty())
+              { w->tasks.push_back(*path);
+                w->tasks.back().push_back(p);
+                ++sh->pending;
+                continue;
+              }
+          }
+
+        State *s1=s->Clone();
+        s1->AddPair(n1, n2);
+        path->push_back(p);
+        bool stop=explore(sh, w, s1, path);
+        path->pop_back();
+        s1->BackTrack();
+        delete s1;
+        if (stop)
+          return true;
+      }
+    return false;
+  }
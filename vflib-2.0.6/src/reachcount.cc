@@ -0,0 +1,76 @@
+/*----------------------------------------------------
+ * reachcount.cc
+ * A function computing, for each node, the number of
+ * nodes within a given distance, used as a dominance
+ * invariant for subgraph isomorphism and monomorphism.
+ ---------------------------------------------------*/
+
+#include "reachcount.h"
+#include "error.h"
+
+static void countReach(Graph *g, node_id node, bool in, int *stamp, 
+                       node_id *queue, int *cnt);
+
+/*----------------------------------------------------
+ * Returns a heap-allocated vector (using new) with
+ * REACH_SIZE counts for each node of g; the counts of
+ * node i start at position i*REACH_SIZE.
+ * Each count is obtained by a breadth-first visit
+ * stopped at depth REACH_RADIUS.
+ ---------------------------------------------------*/
+int* ComputeReachCounts(Graph *g)
+  { int n=g->NodeCount();
+    int *cnt=new int[n*REACH_SIZE+1];
+    int *stamp=new int[n+1];
+    node_id *queue=new node_id[n+1];
+    if (!cnt || !stamp || !queue)
+      OUT_OF_MEMORY();
+
+    int i;
+    for(i=0; i<n; i++)
+      stamp[i]=-1;
+
+    for(i=0; i<n; i++)
+      { countReach(g, i, false, stamp, queue, cnt+i*REACH_SIZE);
+        countReach(g, i, true, stamp, queue, 
+                   cnt+i*REACH_SIZE+REACH_RADIUS);
+      }
+
+    delete[] stamp;
+    delete[] queue;
+    return cnt;
+  }
+
+
+/*----------------------------------------------------
+ * Visits the nodes reachable from 'node' (following
+ * the 'in' edges if in is true) up to REACH_RADIUS
+ * levels, and puts in cnt the cumulative number of 
+ * nodes found at each level.
+ * stamp marks the visited nodes with a distinct value
+ * for each visit, so that it needs not to be cleared.
+ ---------------------------------------------------*/
+static void countReach(Graph *g, node_id node, bool in, int *stamp, 
+                       node_id *queue, int *cnt)
+  { int mark=2*node+(in? 1: 0);
+    int head=0, tail=0, level_end;
+    int level, i, k;
+
+    stamp[node]=mark;
+    queue[tail++]=node;
+    for(level=0; level<REACH_RADIUS; level++)
+      { level_end=tail;
+        while (head<level_end)
+          { node_id n1=queue[head++];
+            k= in? g->InEdgeCount(n1): g->OutEdgeCount(n1);
+            for(i=0; i<k; i++)
+              { node_id n2= in? g->GetInEdge(n1, i): g->GetOutEdge(n1, i);
+                if (stamp[n2]!=mark)
+                  { stamp[n2]=mark;
+                    queue[tail++]=n2;
+                  }
+              }
+          }
+        cnt[level]=tail-1;
+      }
+  }
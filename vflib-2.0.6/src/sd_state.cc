@@ -36,7 +36,9 @@ static void compose_vectors(int n, node_id *a1, node_id *a2,
            node_id *b1, node_id *b2, node_id *out1, node_id *out2);
 
 /*----------------------------------------------------------
- * Methods of class SDState
+ * Methods of class SDStaticState
+ * The methods used at each step of the search are inline,
+ * and are defined in sd_state.h
  ---------------------------------------------------------*/
 
 /*--------------------------------------------------------
@@ -44,7 +46,7 @@ static void compose_vectors(int n, node_id *a1, node_id *a2,
  * the distance matrices and the initial partition
  -------------------------------------------------------*/
 
-SDState::SDState(Graph *g1, Graph *g2)
+SDStaticState::SDStaticState(Graph *g1, Graph *g2)
   { assert(g1!=NULL);
     assert(g2!=NULL);
 
@@ -100,172 +102,11 @@ SDState::SDState(Graph *g1, Graph *g2)
 	  core1[i]=core2[i]=NULL_NODE;
   }
 
-/*-----------------------------------------------------
- * A copy constructor, which builds a new state as a
- * child of the current one.
- ----------------------------------------------------*/
-SDState::SDState(const SDState &state)
-  { parent=(SDState *)&state;
-    core_len=orig_core_len=state.core_len;
-	g1=state.g1;
-	g2=state.g2;
-	n1=state.n1;
-	n2=state.n2;
-	dead_end=state.dead_end;
-	share_count=state.share_count;
-	++ *share_count;
-	dist1=state.dist1;
-	dist2=state.dist2;
-	wrk1=state.wrk1;
-	wrk2=state.wrk2;
-	core1=state.core1;
-	core2=state.core2;
-
-	cls1=new node_id[n1];
-	cls2=new node_id[n1];
-	cnt1=new node_id[n1];
-	cnt2=new node_id[n1];
-    int i;
-	for(i=0; i<n1; i++)
-	    cls1[i]=state.cls1[i];
-	for(i=0; i<n1; i++)
-	    cls2[i]=state.cls2[i];
-	for(i=0; i<n1; i++)
-		cnt1[i]=state.cnt1[i];
-	for(i=0; i<n1; i++)
-		cnt2[i]=state.cnt2[i];
-	   
-  }
-
-
-/*------------------------------------------------------------
- * Destructor. If the state is the topmost one, deallocate
- * also the shared structures.
- -----------------------------------------------------------*/
-SDState::~SDState()
-  { delete[] cls1;
-    delete[] cls2;
-    delete[] cnt1;
-    delete[] cnt2;
-
-	if (share_count==NULL)
-	  return;
-
-	if (-- *share_count == 0)
-	  { delete[] wrk1;
-	    delete[] wrk2;
-		delete[] core1;
-		delete[] core2;
-		delete share_count;
-		int i;
-		for(i=0; i<n1; i++)
-		  { delete[] dist1[i];
-		    delete[] dist2[i];
-		  }
-		delete[] dist1;
-		delete[] dist2;
-	  }
-
-  }
-
-/*-----------------------------------------------------------------------
- * Find the next pair of nodes to be checked for addition to the
- * isomorphism.
- * Returns false if no other pair can be found.
- ----------------------------------------------------------------------*/
-bool SDState::NextPair(node_id *pn1, node_id *pn2,
-                       node_id prev_n1, node_id prev_n2)
-  { if (prev_n1 == NULL_NODE)
-      { prev_n1 = core_len;
-        prev_n2 = 0;
-      }
-    else if (prev_n2 == NULL_NODE)
-      { prev_n2 = 0;
-      }
-    else
-      { prev_n2 ++;
-      }
-
-    assert(core1[prev_n1]==NULL_NODE);
-
-    while (prev_n2 < n2 && 
-          (cls1[prev_n1] != cls2[prev_n2] || core2[prev_n2] != NULL_NODE))
-      prev_n2 ++;
-
-    if (prev_n2 < n2)
-      { *pn1 = prev_n1;
-        *pn2 = prev_n2;
-	return true;
-      }
-    else
-      return false;
-  }
-
-
-/*---------------------------------------------------------
- * Checks if the addition of pair (node1, node2) to the
- * provisional mapping generates a new consistent
- * mapping. 
- * NOTE: For this algorithm this method only checks
- * semantic attribute compatibility.
- ---------------------------------------------------------*/
-bool SDState::IsFeasiblePair(node_id node1, node_id node2)
-  { if (!g1->CompatibleNode(g1->GetNodeAttr(node1),
-                            g2->GetNodeAttr(node2)))
-      return false;
-    int i;
-    node_id o1, o2;
-    void *attr1, *attr2;
-
-
-    for(i=0; i<g1->OutEdgeCount(node1); i++)
-      { o1=g1->GetOutEdge(node1, i, &attr1);
-        if ((o2=core1[o1]) != NULL_NODE)
-	  { attr2=g2->GetEdgeAttr(node2, o2);
-	    if (!g1->CompatibleEdge(attr1, attr2))
-	      return false;
-	  }
-      }
-
-
-    for(i=0; i<g2->OutEdgeCount(node2); i++)
-      { o2=g2->GetOutEdge(node2, i, &attr2);
-        if ((o1=core2[o2]) != NULL_NODE)
-	  { attr1=g1->GetEdgeAttr(node1, o1);
-	    if (!g1->CompatibleEdge(attr1, attr2))
-	      return false;
-	  }
-      }
-
-
-    for(i=0; i<g1->InEdgeCount(node1); i++)
-      { o1=g1->GetInEdge(node1, i, &attr1);
-        if ((o2=core1[o1]) != NULL_NODE)
-	  { attr2=g2->GetEdgeAttr(o2, node2);
-	    if (!g1->CompatibleEdge(attr1, attr2))
-	      return false;
-	  }
-      }
-
-
-    for(i=0; i<g2->InEdgeCount(node2); i++)
-      { o2=g2->GetInEdge(node2, i, &attr2);
-        if ((o1=core2[o2]) != NULL_NODE)
-	  { attr1=g1->GetEdgeAttr(o1, node1);
-	    if (!g1->CompatibleEdge(attr1, attr2))
-	      return false;
-	  }
-      }
-
-
-    return true;
-  }
-
 /*--------------------------------------------------------------
  * Adds a pair (node1, node2) to the current state, recomputing
  * the class vectors and the class count vectors.
  -------------------------------------------------------------*/
-void SDState::AddPair(node_id node1, node_id node2)
+void SDStaticState::AddPair(node_id node1, node_id node2)
   { assert(core_len == orig_core_len);
 
     #ifdef DEBUG_ALGO 
@@ -303,7 +144,7 @@ void SDState::AddPair(node_id node1, node_id node2)
  * Puts in the output vectors c1 and c2 the partial mapping
  * found at the current state.
  -----------------------------------------------------------*/
-void SDState::GetCoreSet(node_id c1[], node_id c2[])
+void SDStaticState::GetCoreSet(node_id c1[], node_id c2[])
   { int i;
     for(i=0; i<core_len; i++)
       { c1[i]=i;
@@ -311,26 +152,6 @@ void SDState::GetCoreSet(node_id c1[], node_id c2[])
       }
   }
 
-/*------------------------------------------------------
- * Creates a copy of the current state
- -----------------------------------------------------*/
-State *SDState::Clone()
-  { return new SDState(*this);
-  }
-  
-
-/*-----------------------------------------------
- * Reverts the effect of the last AddPair on
- * shared data structures
- ----------------------------------------------*/
-void SDState::BackTrack()
-  { if (core_len > orig_core_len)
-      { assert(core_len == orig_core_len+1);
-        core2[core1[orig_core_len]] = NULL_NODE;
-	core1[orig_core_len] = NULL_NODE;
-      }
-  }
-
 
 /*---------------------------------------------------------
  * Static functions
@@ -344,7 +165,7 @@ static node_id **create_distance_matrix(Graph *g)
   { int i, j, k;
     int n=g->NodeCount();
 
-    assert(n < NULL_NODE);
+    assert(n < (long long)NULL_NODE);
 
     node_id **d;
     d=new node_id *[n];
@@ -422,11 +243,11 @@ static void compute_initial_partition(Graph *g1, Graph *g2,
 	   wrk1[i]=wrk2[i]=0;
          for(i=0; i<n; i++)
 	   for(j=0; j<n; j++)
-	     if (dist1[i][j]==col)
+	     if (dist1[i][j]==(node_id)col)
 	       wrk1[i] ++;
          for(i=0; i<n; i++)
 	   for(j=0; j<n; j++)
-	     if (dist2[i][j]==col)
+	     if (dist2[i][j]==(node_id)col)
 	       wrk2[i] ++;
         
 	 compose_vectors(n, cls1, cls2, wrk1, wrk2, tmp1, tmp2);
@@ -436,11 +257,11 @@ static void compute_initial_partition(Graph *g1, Graph *g2,
 	   wrk1[i]=wrk2[i]=0;
          for(i=0; i<n; i++)
 	   for(j=0; j<n; j++)
-	     if (dist1[j][i]==col)
+	     if (dist1[j][i]==(node_id)col)
 	       wrk1[i] ++;
          for(i=0; i<n; i++)
 	   for(j=0; j<n; j++)
-	     if (dist2[j][i]==col)
+	     if (dist2[j][i]==(node_id)col)
 	       wrk2[i] ++;
         
 	 compose_vectors(n, tmp1, tmp2, wrk1, wrk2, cls1, cls2);
@@ -458,7 +279,7 @@ static void count_classes(node_id *cls, int n, node_id *cnt)
     for(i=0; i<n; i++)
       cnt[i]=0;
     for(i=0; i<n; i++)
-      if (cls[i]<n)
+      if (cls[i]<(node_id)n)
         cnt[cls[i]]++;
   }
 
@@ -493,15 +314,17 @@ static int compare(sort_data *x, sort_data *y);
   * The function uses a heap allocated area for storing
   * information needed to sort the input vectors. This area
   * is pointed by a static local variable, so it is shared
-  * by different invocations of the function.
+  * by different invocations of the function; the variable is
+  * thread_local, so that different threads (see parmatch.h)
+  * do not share the area.
   -------------------------------------------------------------*/
 static void compose_vectors(int n, node_id *a1, node_id *a2, 
            node_id *b1, node_id *b2, node_id *out1, node_id *out2)
   { int i, j, cl;
 
-    static int vec_size=0;
-    static sort_data *vec1=NULL;
-    static sort_data *vec2=NULL;
+    static thread_local int vec_size=0;
+    static thread_local sort_data *vec1=NULL;
+    static thread_local sort_data *vec2=NULL;
 
     /*
      * Allocates the auxiliary vectors for sorting the 
@@ -0,0 +1,327 @@
+/*------------------------------------------------------------------
+ * treepeel.cc
+ * Implementation of the class TreeReduction and of tree_match
+ *-----------------------------------------------------------------*/
+
+
+/*-----------------------------------------------------------------
+ *   IMPLEMENTATION NOTES
+ * The neighbours of each node, ignoring the direction of the
+ * edges, are listed with the type of the link: bit 0 set if
+ * there is an edge from the node to the neighbour, bit 1 set
+ * if there is an edge from the neighbour to the node. Self
+ * loops are not counted as neighbours, but are part of the
+ * hash of a removed node.
+ *
+ * The nodes are removed in rounds: in each round all the nodes
+ * with exactly one remaining neighbour are removed together,
+ * except two such nodes adjacent to each other, which are the
+ * centre of a tree and are kept. Since a round does not depend
+ * on the numbering of the nodes, neither does the core. The
+ * hashes are computed in the order of removal, so the subtrees
+ * hanging from a node are done before the node itself.
+ *
+ * Expand pairs the subtrees with an explicit stack, since
+ * a pendant chain can be as long as the graph.
+ *-----------------------------------------------------------------*/
+
+
+#include <stddef.h>
+#include <algorithm>
+#include <utility>
+
+#include "reduce.h"
+#include "argedit.h"
+#include "match.h"
+#include "my_vf2_state.h"
+#include "hashmix.h"
+#include "error.h"
+
+
+typedef unsigned long long uint64;
+
+/*----------------------------------------------------------
+ * Comparison of the nodes by item, to sort the children
+ ---------------------------------------------------------*/
+struct item_less
+  { const std::vector<uint64> *item;
+    item_less(const std::vector<uint64> *item) { this->item=item; }
+    bool operator()(node_id a, node_id b) const
+      { return (*item)[a]<(*item)[b];
+      }
+  };
+
+
+/*----------------------------------------------------------
+ * TreeReduction::TreeReduction(g)
+ * Constructor. Removes the tree-like fringes of g, and
+ * builds the core.
+ ---------------------------------------------------------*/
+TreeReduction::TreeReduction(Graph *g)
+  { this->g=g;
+    int n=g->NodeCount();
+    int i, j, k;
+
+    // List the neighbours of each node
+    std::vector<int> nb_start(n+1, 0);
+    std::vector<node_id> nb;
+    std::vector<int> nb_type;
+    std::vector<bool> loop(n, false);
+    std::vector<std::pair<node_id, int> > tmp;
+    for(i=0; i<n; i++)
+      { tmp.clear();
+        for(j=0; j<g->OutEdgeCount(i); j++)
+          { node_id w=g->GetOutEdge(i, j);
+            if (w==(node_id)i)
+              loop[i]=true;
+            else
+              tmp.push_back(std::make_pair(w, 1));
+          }
+        for(j=0; j<g->InEdgeCount(i); j++)
+          { node_id w=g->GetInEdge(i, j);
+            if (w!=(node_id)i)
+              tmp.push_back(std::make_pair(w, 2));
+          }
+        std::sort(tmp.begin(), tmp.end());
+        for(k=0; k<(int)tmp.size(); k++)
+          { if ((int)nb.size()>nb_start[i] && nb.back()==tmp[k].first)
+              nb_type.back()|=tmp[k].second;
+            else
+              { nb.push_back(tmp[k].first);
+                nb_type.push_back(tmp[k].second);
+              }
+          }
+        nb_start[i+1]=nb.size();
+      }
+
+    // Remove the nodes with one neighbour, round after round
+    std::vector<int> deg(n), link(n, 0);
+    std::vector<bool> alive(n, true), centre(n, false);
+    std::vector<node_id> leaves, next, removed;
+    parent.assign(n, NULL_NODE);
+    for(i=0; i<n; i++)
+      { deg[i]=nb_start[i+1]-nb_start[i];
+        if (deg[i]==1)
+          leaves.push_back(i);
+      }
+    while (!leaves.empty())
+      { for(k=0; k<(int)leaves.size(); k++)
+          { node_id v=leaves[k];
+            for(j=nb_start[v]; !alive[nb[j]]; j++)
+              ;
+            parent[v]=nb[j];
+            link[v]=nb_type[j];
+          }
+        for(k=0; k<(int)leaves.size(); k++)
+          if (deg[parent[leaves[k]]]==1)
+            centre[leaves[k]]=true;
+
+        next.clear();
+        for(k=0; k<(int)leaves.size(); k++)
+          { node_id v=leaves[k];
+            if (centre[v])
+              { parent[v]=NULL_NODE;
+                continue;
+              }
+            alive[v]=false;
+            removed.push_back(v);
+            if (--deg[parent[v]]==1)
+              next.push_back(parent[v]);
+          }
+
+        leaves.clear();
+        for(k=0; k<(int)next.size(); k++)
+          if (deg[next[k]]==1 && !centre[next[k]])
+            leaves.push_back(next[k]);
+      }
+
+    // List the children of each node
+    child_start.assign(n+1, 0);
+    for(i=0; i<n; i++)
+      if (parent[i]!=NULL_NODE)
+        child_start[parent[i]+1]++;
+    for(i=0; i<n; i++)
+      child_start[i+1]+=child_start[i];
+    child.resize(child_start[n]);
+    std::vector<int> pos(child_start.begin(), child_start.end()-1);
+    for(i=0; i<n; i++)
+      if (parent[i]!=NULL_NODE)
+        child[pos[parent[i]]++]=i;
+
+    // Compute the hashes of the subtrees and the colours,
+    // after the ones of the removed nodes
+    item.assign(n, 0);
+    std::vector<uint64> hash(n, 0);
+    for(i=0; i<n; i++)
+      if (alive[i])
+        removed.push_back(i);
+    for(k=0; k<(int)removed.size(); k++)
+      { node_id v=removed[k];
+        std::sort(child.begin()+child_start[v], child.begin()+child_start[v+1],
+                  item_less(&item));
+        uint64 h=hash_mix(loop[v]? 0x7472656531ULL: 0x7472656530ULL);
+        for(j=child_start[v]; j<child_start[v+1]; j++)
+          h=hash_mix(h^item[child[j]]);
+        hash[v]=hash_mix(h^(uint64)(child_start[v+1]-child_start[v]));
+        if (parent[v]!=NULL_NODE)
+          item[v]=hash_mix(hash[v]+hash_mix((uint64)link[v]));
+      }
+
+    // Build the core
+    std::vector<node_id> core_id(n, NULL_NODE);
+    for(i=0; i<n; i++)
+      if (alive[i])
+        { core_id[i]=core_node.size();
+          core_node.push_back(i);
+          colour.push_back(hash[i]);
+        }
+    ARGEdit ed;
+    for(k=0; k<(int)core_node.size(); k++)
+      ed.InsertNode(&colour[k]);
+    for(k=0; k<(int)core_node.size(); k++)
+      { node_id v=core_node[k];
+        for(j=0; j<g->OutEdgeCount(v); j++)
+          { node_id w=g->GetOutEdge(v, j);
+            if (alive[w])
+              ed.InsertEdge(k, core_id[w], NULL);
+          }
+      }
+    core=new Graph(&ed);
+    if (!core)
+      error("Out of memory");
+    core->SetNodeComparator(new ColourComparator());
+  }
+
+
+/*----------------------------------------------------------
+ * TreeReduction::~TreeReduction()
+ * Destructor.
+ ---------------------------------------------------------*/
+TreeReduction::~TreeReduction()
+  { delete core;
+  }
+
+
+/*----------------------------------------------------------
+ * bool TreeReduction::SameColours(r)
+ * Returns true if the multisets of the colours of the
+ * cores of this reduction and of r are equal.
+ ---------------------------------------------------------*/
+bool TreeReduction::SameColours(TreeReduction *r)
+  { if (colour.size()!=r->colour.size())
+      return false;
+    std::vector<uint64> a(colour), b(r->colour);
+    std::sort(a.begin(), a.end());
+    std::sort(b.begin(), b.end());
+    return a==b;
+  }
+
+
+/*----------------------------------------------------------
+ * int TreeReduction::Expand(r, n, core1, core2, c1, c2)
+ * Given a matching of n nodes between the core of this
+ * reduction and the core of r, computes the matching of the
+ * whole graphs, pairing the subtrees hanging from paired
+ * nodes. c1 and c2 receive the ids of the corresponding
+ * nodes of the two graphs. Returns the number of pairs,
+ * which is less than the number of nodes only if a hash
+ * collision has paired different subtrees.
+ ---------------------------------------------------------*/
+int TreeReduction::Expand(TreeReduction *r, int n,
+                           node_id core1[], node_id core2[],
+                           node_id c1[], node_id c2[])
+  { std::vector<std::pair<node_id, node_id> > stack;
+    int i, j, k=0;
+    for(i=0; i<n; i++)
+      stack.push_back(std::make_pair(core_node[core1[i]],
+                                     r->core_node[core2[i]]));
+    while (!stack.empty())
+      { node_id u=stack.back().first, w=stack.back().second;
+        stack.pop_back();
+        c1[k]=u;
+        c2[k]=w;
+        k++;
+        int len=std::min(child_start[u+1]-child_start[u],
+                         r->child_start[w+1]-r->child_start[w]);
+        for(j=0; j<len; j++)
+          stack.push_back(std::make_pair(child[child_start[u]+j],
+                                         r->child[r->child_start[w]+j]));
+      }
+    return k;
+  }
+
+
+/*----------------------------------------------------------
+ * bool tree_match(g1, g2, pn, c1, c2)
+ * Finds an isomorphism between g1 and g2 matching the cores
+ * of their TreeReductions. Returns true if the graphs are
+ * isomorphic; *pn is then assigned the number of nodes, and
+ * c1 and c2 will contain the ids of the corresponding nodes
+ * in the two graphs.
+ ---------------------------------------------------------*/
+bool tree_match(Graph *g1, Graph *g2, int *pn, node_id c1[], node_id c2[])
+  { int n=g1->NodeCount();
+    if (n!=g2->NodeCount())
+      return false;
+    if (n==0)
+      { *pn=0;
+        return true;
+      }
+
+    TreeReduction r1(g1), r2(g2);
+    if (!r1.SameColours(&r2))
+      return false;
+
+    int m=r1.CoreNodeCount(), nc, k=0;
+    node_id *cc1=new node_id[m];
+    node_id *cc2=new node_id[m];
+    if (!cc1 || !cc2)
+      error("Out of memory");
+    bool found;
+      { MyVF2State s(r1.GetCore(), r2.GetCore());
+        found=match(&s, &nc, cc1, cc2);
+      }
+    if (found)
+      k=r1.Expand(&r2, nc, cc1, cc2, c1, c2);
+    delete[] cc1;
+    delete[] cc2;
+    if (!found)
+      return false;
+
+    if (k==n && CheckIsomorphism(g1, g2, n, c1, c2))
+      { *pn=n;
+        return true;
+      }
+
+    // A hash collision has occurred
+    MyVF2State s(g1, g2);
+    return match(&s, pn, c1, c2);
+  }
+
+
+
+/*----------------------------------------------------------
+ * bool CheckIsomorphism(g1, g2, n, c1, c2)
+ * Checks that the n pairs (c1[i], c2[i]) are an isomorphism
+ * between g1 and g2 (attributes are not considered).
+ ---------------------------------------------------------*/
+bool CheckIsomorphism(Graph *g1, Graph *g2, int n,
+                      node_id c1[], node_id c2[])
+  { std::vector<node_id> map(n, NULL_NODE);
+    std::vector<bool> used(n, false);
+    int i, j;
+    for(i=0; i<n; i++)
+      { if (map[c1[i]]!=NULL_NODE || used[c2[i]])
+          return false;
+        map[c1[i]]=c2[i];
+        used[c2[i]]=true;
+      }
+    for(i=0; i<n; i++)
+      { if (g1->OutEdgeCount(i)!=g2->OutEdgeCount(map[i]))
+          return false;
+        for(j=0; j<g1->OutEdgeCount(i); j++)
+          if (!g2->HasEdge(map[i], map[g1->GetOutEdge(i, j)]))
+            return false;
+      }
+    return true;
+  }
@@ -0,0 +1,362 @@
+/*------------------------------------------------------------------
+ * twins.cc
+ * Implementation of the class TwinReduction and of twin_match
+ *-----------------------------------------------------------------*/
+
+
+/*-----------------------------------------------------------------
+ *   IMPLEMENTATION NOTES
+ * The collapse works on levels: a level is a graph, with its
+ * sorted out and in lists (without self loops), a self loop
+ * flag and a colour for each node, and the node of g or class
+ * each of its nodes stands for (the nodes of g are numbered
+ * from 0 to n-1, the classes from n on, in order of creation).
+ *
+ * To find the twins, each node gets a key vector (its out
+ * list, a separator and its in list, with the node itself
+ * added for the true twins); the nodes are sorted by a hash of
+ * colour, loop flag and key, and the nodes with the same hash
+ * are compared exactly, so a collision of the hashes never
+ * puts together nodes that are not twins.
+ *-----------------------------------------------------------------*/
+
+
+#include <stddef.h>
+#include <algorithm>
+#include <utility>
+
+#include "reduce.h"
+#include "argedit.h"
+#include "match.h"
+#include "my_vf2_state.h"
+#include "hashmix.h"
+#include "error.h"
+
+
+typedef unsigned long long uint64;
+
+enum { FALSE_TWINS=1, TRUE_TWINS=2 };
+
+struct level
+  { std::vector<std::vector<int> > out, in;
+    std::vector<bool> loop;
+    std::vector<uint64> colour;
+    std::vector<int> node;
+  };
+
+static int find_twins(level *lv, bool closed, std::vector<int> &cls,
+                      int ncls);
+
+
+/*----------------------------------------------------------
+ * TwinReduction::TwinReduction(g)
+ * Constructor. Collapses the twins of g, and builds the core.
+ ---------------------------------------------------------*/
+TwinReduction::TwinReduction(Graph *g)
+  { this->g=g;
+    int n=g->NodeCount();
+    int i, j, k;
+
+    level lv;
+    lv.out.resize(n);
+    lv.in.resize(n);
+    lv.loop.assign(n, false);
+    lv.colour.assign(n, hash_mix(0x7477696e30ULL));
+    lv.node.resize(n);
+    for(i=0; i<n; i++)
+      { lv.node[i]=i;
+        for(j=0; j<g->OutEdgeCount(i); j++)
+          { node_id w=g->GetOutEdge(i, j);
+            if (w==(node_id)i)
+              lv.loop[i]=true;
+            else
+              lv.out[i].push_back(w);
+          }
+        for(j=0; j<g->InEdgeCount(i); j++)
+          { node_id w=g->GetInEdge(i, j);
+            if (w!=(node_id)i)
+              lv.in[i].push_back(w);
+          }
+        std::sort(lv.out[i].begin(), lv.out[i].end());
+        std::sort(lv.in[i].begin(), lv.in[i].end());
+      }
+
+    member_start.push_back(0);
+    for(;;)
+      { int m=lv.node.size();
+        std::vector<int> cls(m, -1);
+        int ncls=find_twins(&lv, false, cls, 0);
+        int nfalse=ncls;
+        ncls=find_twins(&lv, true, cls, ncls);
+        if (ncls==0)
+          break;
+
+        // Build the next level: a node for each class, followed
+        // by the nodes not in any class
+        level nx;
+        std::vector<int> idx(m);
+        nx.node.resize(ncls);
+        nx.loop.resize(ncls);
+        nx.colour.resize(ncls);
+        std::vector<std::vector<int> > mem(ncls);
+        for(i=0; i<m; i++)
+          if (cls[i]>=0)
+            mem[cls[i]].push_back(i);
+        for(k=0; k<ncls; k++)
+          { int type=k<nfalse? FALSE_TWINS: TRUE_TWINS;
+            int first=mem[k][0];
+            nx.node[k]=n+member_start.size()-1;
+            nx.loop[k]=lv.loop[first];
+            nx.colour[k]=hash_mix(hash_mix(lv.colour[first]+(uint64)type)^
+                             (uint64)mem[k].size());
+            for(j=0; j<(int)mem[k].size(); j++)
+              member.push_back(lv.node[mem[k][j]]);
+            member_start.push_back(member.size());
+          }
+        for(i=0; i<m; i++)
+          { if (cls[i]>=0)
+              idx[i]=cls[i];
+            else
+              { idx[i]=nx.node.size();
+                nx.node.push_back(lv.node[i]);
+                nx.loop.push_back(lv.loop[i]);
+                nx.colour.push_back(lv.colour[i]);
+              }
+          }
+
+        int m1=nx.node.size();
+        nx.out.resize(m1);
+        nx.in.resize(m1);
+        for(i=0; i<m; i++)
+          { int u=idx[i];
+            for(j=0; j<(int)lv.out[i].size(); j++)
+              { int w=idx[lv.out[i][j]];
+                if (w!=u)
+                  { nx.out[u].push_back(w);
+                    nx.in[w].push_back(u);
+                  }
+              }
+          }
+        for(i=0; i<m1; i++)
+          { std::sort(nx.out[i].begin(), nx.out[i].end());
+            nx.out[i].erase(std::unique(nx.out[i].begin(), nx.out[i].end()),
+                            nx.out[i].end());
+            std::sort(nx.in[i].begin(), nx.in[i].end());
+            nx.in[i].erase(std::unique(nx.in[i].begin(), nx.in[i].end()),
+                           nx.in[i].end());
+          }
+
+        std::swap(lv.out, nx.out);
+        std::swap(lv.in, nx.in);
+        std::swap(lv.loop, nx.loop);
+        std::swap(lv.colour, nx.colour);
+        std::swap(lv.node, nx.node);
+      }
+
+    // Build the core
+    int m=lv.node.size();
+    core_node=lv.node;
+    colour=lv.colour;
+    ARGEdit ed;
+    for(k=0; k<m; k++)
+      ed.InsertNode(&colour[k]);
+    for(k=0; k<m; k++)
+      { if (lv.loop[k])
+          ed.InsertEdge(k, k, NULL);
+        for(j=0; j<(int)lv.out[k].size(); j++)
+          ed.InsertEdge(k, lv.out[k][j], NULL);
+      }
+    core=new Graph(&ed);
+    if (!core)
+      error("Out of memory");
+    core->SetNodeComparator(new ColourComparator());
+  }
+
+
+/*----------------------------------------------------------
+ * TwinReduction::~TwinReduction()
+ * Destructor.
+ ---------------------------------------------------------*/
+TwinReduction::~TwinReduction()
+  { delete core;
+  }
+
+
+/*----------------------------------------------------------
+ * bool TwinReduction::SameColours(r)
+ * Returns true if the multisets of the colours of the
+ * cores of this reduction and of r are equal.
+ ---------------------------------------------------------*/
+bool TwinReduction::SameColours(TwinReduction *r)
+  { if (colour.size()!=r->colour.size())
+      return false;
+    std::vector<uint64> a(colour), b(r->colour);
+    std::sort(a.begin(), a.end());
+    std::sort(b.begin(), b.end());
+    return a==b;
+  }
+
+
+/*----------------------------------------------------------
+ * int TwinReduction::Expand(r, n, core1, core2, c1, c2)
+ * Given a matching of n nodes between the core of this
+ * reduction and the core of r, computes the matching of the
+ * whole graphs, pairing the members of paired classes.
+ * c1 and c2 receive the ids of the corresponding nodes of
+ * the two graphs. Returns the number of pairs, which is less
+ * than the number of nodes only if a hash collision has
+ * paired different classes.
+ ---------------------------------------------------------*/
+int TwinReduction::Expand(TwinReduction *r, int n,
+                          node_id core1[], node_id core2[],
+                          node_id c1[], node_id c2[])
+  { int n1=g->NodeCount(), n2=r->g->NodeCount();
+    std::vector<std::pair<int, int> > stack;
+    int i, j, k=0;
+    for(i=0; i<n; i++)
+      stack.push_back(std::make_pair(core_node[core1[i]],
+                                     r->core_node[core2[i]]));
+    while (!stack.empty())
+      { int u=stack.back().first, w=stack.back().second;
+        stack.pop_back();
+        if (u<n1 && w<n2)
+          { c1[k]=u;
+            c2[k]=w;
+            k++;
+          }
+        else if (u>=n1 && w>=n2)
+          { int s1=member_start[u-n1], e1=member_start[u-n1+1];
+            int s2=r->member_start[w-n2], e2=r->member_start[w-n2+1];
+            for(j=0; j<e1-s1 && j<e2-s2; j++)
+              stack.push_back(std::make_pair(member[s1+j],
+                                             r->member[s2+j]));
+          }
+      }
+    return k;
+  }
+
+
+/*----------------------------------------------------------
+ * bool twin_match(g1, g2, pn, c1, c2)
+ * Finds an isomorphism between g1 and g2 matching the cores
+ * of their TwinReductions. Returns true if the graphs are
+ * isomorphic; *pn is then assigned the number of nodes, and
+ * c1 and c2 will contain the ids of the corresponding nodes
+ * in the two graphs.
+ ---------------------------------------------------------*/
+bool twin_match(Graph *g1, Graph *g2, int *pn, node_id c1[], node_id c2[])
+  { int n=g1->NodeCount();
+    if (n!=g2->NodeCount())
+      return false;
+    if (n==0)
+      { *pn=0;
+        return true;
+      }
+
+    TwinReduction r1(g1), r2(g2);
+    if (!r1.SameColours(&r2))
+      return false;
+
+    int m=r1.CoreNodeCount(), nc, k=0;
+    node_id *cc1=new node_id[m];
+    node_id *cc2=new node_id[m];
+    if (!cc1 || !cc2)
+      error("Out of memory");
+    bool found;
+      { MyVF2State s(r1.GetCore(), r2.GetCore());
+        found=match(&s, &nc, cc1, cc2);
+      }
+    if (found)
+      k=r1.Expand(&r2, nc, cc1, cc2, c1, c2);
+    delete[] cc1;
+    delete[] cc2;
+    if (!found)
+      return false;
+
+    if (k==n && CheckIsomorphism(g1, g2, n, c1, c2))
+      { *pn=n;
+        return true;
+      }
+
+    // A hash collision has occurred
+    MyVF2State s(g1, g2);
+    return match(&s, pn, c1, c2);
+  }
+
+
+
+/*---------------------------------------------------------
+ * Static functions
+ --------------------------------------------------------*/
+
+/*-------------------------------------------------------------
+ * Finds the classes of false twins (closed==false) or true
+ * twins (closed==true) among the nodes with cls[i]<0, and
+ * numbers them from ncls on. Returns the new number of
+ * classes.
+ ------------------------------------------------------------*/
+static int find_twins(level *lv, bool closed, std::vector<int> &cls,
+                      int ncls)
+  { int m=lv->node.size();
+    int i, j;
+
+    std::vector<std::vector<int> > key(m);
+    std::vector<std::pair<uint64, int> > h;
+    for(i=0; i<m; i++)
+      { if (cls[i]>=0)
+          continue;
+        std::vector<int> &v=key[i];
+        v=lv->out[i];
+        if (closed)
+          v.insert(std::lower_bound(v.begin(), v.end(), i), i);
+        v.push_back(-1);
+        int mid=v.size();
+        v.insert(v.end(), lv->in[i].begin(), lv->in[i].end());
+        if (closed)
+          v.insert(std::lower_bound(v.begin()+mid, v.end(), i), i);
+
+        uint64 x=hash_mix(lv->colour[i]^(lv->loop[i]? 1: 0));
+        for(j=0; j<(int)v.size(); j++)
+          x=hash_mix(x^(uint64)(unsigned)v[j]);
+        h.push_back(std::make_pair(x, i));
+      }
+    std::sort(h.begin(), h.end());
+
+    int begin, end;
+    std::vector<int> rep;
+    for(begin=0; begin<(int)h.size(); begin=end)
+      { for(end=begin+1; end<(int)h.size() && h[end].first==h[begin].first;
+            end++)
+          ;
+        if (end-begin<2)
+          continue;
+
+        // Split the nodes with the same hash into the classes of
+        // equal keys; rep holds a node for each class
+        rep.clear();
+        std::vector<int> count;
+        for(i=begin; i<end; i++)
+          { int u=h[i].second;
+            for(j=0; j<(int)rep.size(); j++)
+              if (key[rep[j]]==key[u] &&
+                  lv->colour[rep[j]]==lv->colour[u] &&
+                  lv->loop[rep[j]]==lv->loop[u])
+                break;
+            if (j==(int)rep.size())
+              { rep.push_back(u);
+                count.push_back(0);
+              }
+            cls[u]=j;
+            count[j]++;
+          }
+
+        // Number the classes with more than one node
+        std::vector<int> num(rep.size(), -1);
+        for(j=0; j<(int)rep.size(); j++)
+          if (count[j]>1)
+            num[j]=ncls++;
+        for(i=begin; i<end; i++)
+          cls[h[i].second]=num[cls[h[i].second]];
+      }
+    return ncls;
+  }
@@ -152,16 +152,16 @@ bool UllSubState::NextPair(node_id *pn1, node_id *pn2,
     else
       prev_n2++;
 
-    if (prev_n2>=n2)
+    if (prev_n2>=(node_id)n2)
       { prev_n1++;
         prev_n2=0;
       }
 
-    if (prev_n1!=core_len)
+    if (prev_n1!=(node_id)core_len)
       return false;
-    while (prev_n2<n2 && M[prev_n1][prev_n2]==0)
+    while (prev_n2<(node_id)n2 && M[prev_n1][prev_n2]==0)
       prev_n2++;
-    if (prev_n2<n2)
+    if (prev_n2<(node_id)n2)
       { *pn1=prev_n1;
         *pn2=prev_n2;
         return true;
@@ -177,8 +177,8 @@ bool UllSubState::NextPair(node_id *pn1, node_id *pn2,
  * Returns true if (node1, node2) can be added to the state
  --------------------------------------------------------------*/
 bool UllSubState::IsFeasiblePair(node_id node1, node_id node2)
-  { assert(node1<n1);
-    assert(node2<n2);
+  { assert(node1<(node_id)n1);
+    assert(node2<(node_id)n2);
 
     return M[node1][node2]!=0;
   }
@@ -191,8 +191,8 @@ bool UllSubState::IsFeasiblePair(node_id node1, node_id node2)
  * Precondition: the pair must be feasible
  -------------------------------------------------------------*/
 void UllSubState::AddPair(node_id node1, node_id node2)
-  { assert(node1<n1);
-    assert(node2<n2);
+  { assert(node1<(node_id)n1);
+    assert(node2<(node_id)n2);
     assert(core_len<n1);
     assert(core_len<n2);
 
@@ -240,29 +240,29 @@ void UllSubState::refine()
     for(i=core_len; i<n1; i++)
       for(j=0; j<n2; j++)
         if (M[i][j])
-          { bool edge_ik, edge_ki, edge_jl, edge_lj;
+          { int edge_ik, edge_ki, edge_jl, edge_lj;  // slots, or -1
 		    // The following (commented-out) for wasn't necessary
             //for(k=0; k<core_len; k++)
 			for(k=core_len-1; k<core_len; k++)
               { l=core_1[k];
-                assert(l!=NULL_NODE);
-                edge_ik=g1->HasEdge(i,k);
-                edge_ki=g1->HasEdge(k,i);
-                edge_jl=g2->HasEdge(j,l);
-                edge_lj=g2->HasEdge(l,j);
-                if (edge_ik!=edge_jl || edge_ki!=edge_lj)
+                assert(l!=(int)NULL_NODE);
+                edge_ik=g1->FindEdge(i,k);
+                edge_ki=g1->FindEdge(k,i);
+                edge_jl=g2->FindEdge(j,l);
+                edge_lj=g2->FindEdge(l,j);
+                if ((edge_ik<0)!=(edge_jl<0) || (edge_ki<0)!=(edge_lj<0))
                   { M[i][j]=0;
                     break;
                   }
-                else if (edge_ik  &&
-                         !g1->CompatibleEdge(g1->GetEdgeAttr(i,k),
-                                             g2->GetEdgeAttr(j,l)))
+                else if (edge_ik>=0 &&
+                         !g1->CompatibleEdge(g1->GetSlotAttr(edge_ik),
+                                             g2->GetSlotAttr(edge_jl)))
                   { M[i][j]=0;
                     break;
                   }
-                else if (edge_ki  &&
-                         !g1->CompatibleEdge(g1->GetEdgeAttr(k,i),
-                                             g2->GetEdgeAttr(l,j)))
+                else if (edge_ki>=0 &&
+                         !g1->CompatibleEdge(g1->GetSlotAttr(edge_ki),
+                                             g2->GetSlotAttr(edge_lj)))
                   { M[i][j]=0;
                     break;
                   }
@@ -169,7 +169,7 @@ bool VF2SubState::NextPair(node_id *pn1, node_id *pn2,
       prev_n2++;
 
 	if (t1both_len>core_len && t2both_len>core_len)
-	  { while (prev_n1<n1 &&
+	  { while (prev_n1<(node_id)n1 &&
            (core_1[prev_n1]!=NULL_NODE || out_1[prev_n1]==0
 		            || in_1[prev_n1]==0) )
           { prev_n1++;    
@@ -177,14 +177,14 @@ bool VF2SubState::NextPair(node_id *pn1, node_id *pn2,
           }
 	  }
 	else if (t1out_len>core_len && t2out_len>core_len)
-	  { while (prev_n1<n1 &&
+	  { while (prev_n1<(node_id)n1 &&
            (core_1[prev_n1]!=NULL_NODE || out_1[prev_n1]==0) )
           { prev_n1++;    
             prev_n2=0;
           }
 	  }
     else if (t1in_len>core_len && t2in_len>core_len)
-	  { while (prev_n1<n1 &&
+	  { while (prev_n1<(node_id)n1 &&
            (core_1[prev_n1]!=NULL_NODE || in_1[prev_n1]==0) )
           { prev_n1++;    
             prev_n2=0;
@@ -198,7 +198,7 @@ bool VF2SubState::NextPair(node_id *pn1, node_id *pn2,
 	      prev_n1=n1;
 	  }
 	else
-	  { while (prev_n1<n1 && core_1[prev_n1]!=NULL_NODE )
+	  { while (prev_n1<(node_id)n1 && core_1[prev_n1]!=NULL_NODE )
           { prev_n1++;    
             prev_n2=0;
           }
@@ -207,32 +207,32 @@ bool VF2SubState::NextPair(node_id *pn1, node_id *pn2,
 
 
 	if (t1both_len>core_len && t2both_len>core_len)
-	  { while (prev_n2<n2 &&
+	  { while (prev_n2<(node_id)n2 &&
            (core_2[prev_n2]!=NULL_NODE || out_2[prev_n2]==0
 		            || in_2[prev_n2]==0) )
           { prev_n2++;    
           }
 	  }
 	else if (t1out_len>core_len && t2out_len>core_len)
-	  { while (prev_n2<n2 &&
+	  { while (prev_n2<(node_id)n2 &&
            (core_2[prev_n2]!=NULL_NODE || out_2[prev_n2]==0) )
           { prev_n2++;    
           }
 	  }
     else if (t1in_len>core_len && t2in_len>core_len)
-	  { while (prev_n2<n2 &&
+	  { while (prev_n2<(node_id)n2 &&
            (core_2[prev_n2]!=NULL_NODE || in_2[prev_n2]==0) )
           { prev_n2++;    
           }
 	  }
 	else
-	  { while (prev_n2<n2 && core_2[prev_n2]!=NULL_NODE )
+	  { while (prev_n2<(node_id)n2 && core_2[prev_n2]!=NULL_NODE )
           { prev_n2++;    
           }
 	  }
 	  
 
-    if (prev_n1<n1 && prev_n2<n2)
+    if (prev_n1<(node_id)n1 && prev_n2<(node_id)n2)
           { *pn1=prev_n1;
             *pn2=prev_n2;
             return true;
@@ -255,8 +255,8 @@ bool VF2SubState::NextPair(node_id *pn1, node_id *pn2,
  *   criterion is not symmetric.
  --------------------------------------------------------------*/
 bool VF2SubState::IsFeasiblePair(node_id node1, node_id node2)
-  { assert(node1<n1);
-    assert(node2<n2);
+  { assert(node1<(node_id)n1);
+    assert(node2<(node_id)n2);
     assert(core_1[node1]==NULL_NODE);
     assert(core_2[node2]==NULL_NODE);
 
@@ -272,8 +272,8 @@ bool VF2SubState::IsFeasiblePair(node_id node1, node_id node2)
       { other1=g1->GetOutEdge(node1, i, &attr1);
         if (core_1[other1] != NULL_NODE)
           { other2=core_1[other1];
-            if (!g2->HasEdge(node2, other2) ||
-                !g1->CompatibleEdge(attr1, g2->GetEdgeAttr(node2, other2)))
+            int e=g2->FindEdge(node2, other2);
+            if (e<0 || !g1->CompatibleEdge(attr1, g2->GetSlotAttr(e)))
               return false;
           }
         else 
@@ -291,8 +291,8 @@ bool VF2SubState::IsFeasiblePair(node_id node1, node_id node2)
       { other1=g1->GetInEdge(node1, i, &attr1);
         if (core_1[other1]!=NULL_NODE)
           { other2=core_1[other1];
-            if (!g2->HasEdge(other2, node2) ||
-                !g1->CompatibleEdge(attr1, g2->GetEdgeAttr(other2, node2)))
+            int e=g2->FindEdge(other2, node2);
+            if (e<0 || !g1->CompatibleEdge(attr1, g2->GetSlotAttr(e)))
               return false;
           }
         else 
@@ -353,8 +353,8 @@ bool VF2SubState::IsFeasiblePair(node_id node1, node_id node2)
  * Precondition: the pair must be feasible
  -------------------------------------------------------------*/
 void VF2SubState::AddPair(node_id node1, node_id node2)
-  { assert(node1<n1);
-    assert(node2<n2);
+  { assert(node1<(node_id)n1);
+    assert(node2<(node_id)n2);
     assert(core_len<n1);
     assert(core_len<n2);
 
@@ -466,42 +466,42 @@ State* VF2SubState::Clone()
  ----------------------------------------------------------------*/
 void VF2SubState::BackTrack()
   { assert(core_len - orig_core_len <= 1);
-    assert(added_node1 != NULL_NODE);
+    assert(added_node1 != (int)NULL_NODE);
   
     if (orig_core_len < core_len)
       { int i, node2;
 
-        if (in_1[added_node1] == core_len)
+        if (in_1[added_node1] == (node_id)core_len)
 		  in_1[added_node1] = 0;
 	    for(i=0; i<g1->InEdgeCount(added_node1); i++)
 		  { int other=g1->GetInEdge(added_node1, i);
-		    if (in_1[other]==core_len)
+		    if (in_1[other]==(node_id)core_len)
 			  in_1[other]=0;
 		  }
         
-		if (out_1[added_node1] == core_len)
+		if (out_1[added_node1] == (node_id)core_len)
 		  out_1[added_node1] = 0;
 	    for(i=0; i<g1->OutEdgeCount(added_node1); i++)
 		  { int other=g1->GetOutEdge(added_node1, i);
-		    if (out_1[other]==core_len)
+		    if (out_1[other]==(node_id)core_len)
 			  out_1[other]=0;
 		  }
 	    
 		node2 = core_1[added_node1];
 
-        if (in_2[node2] == core_len)
+        if (in_2[node2] == (node_id)core_len)
 		  in_2[node2] = 0;
 	    for(i=0; i<g2->InEdgeCount(node2); i++)
 		  { int other=g2->GetInEdge(node2, i);
-		    if (in_2[other]==core_len)
+		    if (in_2[other]==(node_id)core_len)
 			  in_2[other]=0;
 		  }
         
-		if (out_2[node2] == core_len)
+		if (out_2[node2] == (node_id)core_len)
 		  out_2[node2] = 0;
 	    for(i=0; i<g2->OutEdgeCount(node2); i++)
 		  { int other=g2->GetOutEdge(node2, i);
-		    if (out_2[other]==core_len)
+		    if (out_2[other]==(node_id)core_len)
 			  out_2[other]=0;
 		  }
 	    
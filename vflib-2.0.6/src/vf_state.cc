@@ -133,16 +133,16 @@ bool VFState::NextPair(node_id *pn1, node_id *pn2,
     else
       prev_n2++;
 
-    while (prev_n1<n1 &&
+    while (prev_n1<(node_id)n1 &&
            (node_flags_1[prev_n1] & cond1)!=cond2)
       { prev_n1++;    
         prev_n2=0;
       }
 
-    while (prev_n2<n2 &&
+    while (prev_n2<(node_id)n2 &&
                (node_flags_2[prev_n2] & cond1)!=cond2)
           prev_n2++;
-    if (prev_n1<n1 && prev_n2<n2)
+    if (prev_n1<(node_id)n1 && prev_n2<(node_id)n2)
           { *pn1=prev_n1;
             *pn2=prev_n2;
             return true;
@@ -165,8 +165,8 @@ bool VFState::NextPair(node_id *pn1, node_id *pn2,
  *   criterion is not symmetric.
  --------------------------------------------------------------*/
 bool VFState::IsFeasiblePair(node_id node1, node_id node2)
-  { assert(node1<n1);
-    assert(node2<n2);
+  { assert(node1<(node_id)n1);
+    assert(node2<(node_id)n2);
     assert((node_flags_1[node1] & ST_CORE)==0);
     assert((node_flags_2[node2] & ST_CORE)==0);
 
@@ -182,8 +182,8 @@ bool VFState::IsFeasiblePair(node_id node1, node_id node2)
       { other1=g1->GetOutEdge(node1, i, &attr1);
         if ((flags=node_flags_1[other1]) & ST_CORE)
           { other2=core_1[other1];
-            if (!g2->HasEdge(node2, other2) ||
-                !g1->CompatibleEdge(attr1, g2->GetEdgeAttr(node2, other2)))
+            int e=g2->FindEdge(node2, other2);
+            if (e<0 || !g1->CompatibleEdge(attr1, g2->GetSlotAttr(e)))
               return false;
           }
         else 
@@ -201,8 +201,8 @@ bool VFState::IsFeasiblePair(node_id node1, node_id node2)
       { other1=g1->GetInEdge(node1, i, &attr1);
         if ((flags=node_flags_1[other1]) & ST_CORE)
           { other2=core_1[other1];
-            if (!g2->HasEdge(other2, node2) ||
-                !g1->CompatibleEdge(attr1, g2->GetEdgeAttr(other2, node2)))
+            int e=g2->FindEdge(other2, node2);
+            if (e<0 || !g1->CompatibleEdge(attr1, g2->GetSlotAttr(e)))
               return false;
           }
         else 
@@ -263,8 +263,8 @@ bool VFState::IsFeasiblePair(node_id node1, node_id node2)
  * Precondition: the pair must be feasible
  -------------------------------------------------------------*/
 void VFState::AddPair(node_id node1, node_id node2)
-  { assert(node1<n1);
-    assert(node2<n2);
+  { assert(node1<(node_id)n1);
+    assert(node2<(node_id)n2);
     assert(core_len<n1);
     assert(core_len<n2);
     int flags;
@@ -70,7 +70,7 @@ Graph* ExtractSubgraph(Graph *g, int nodes, bool connected)
         
 	do {
 	  while (map[id]!=NULL_NODE) 
-	    { if (++id == n)
+	    { if (++id == (node_id)n)
 	        id=0;
               if (id==id0)
 	        { if (i==0 || !connected)
@@ -92,7 +92,7 @@ Graph* ExtractSubgraph(Graph *g, int nodes, bool connected)
 		    found=true;
 		}
 	      if (!found)
-	        { if (++id == n)
+	        { if (++id == (node_id)n)
 	            id=0;
                   if (id==id0)
 	            FAIL("Cannot extract a connected subgraph");
@@ -0,0 +1,357 @@
+/*------------------------------------------------------------------
+ * zstream.cc
+ * Implementation of the class DecompressBuf
+ *-----------------------------------------------------------------*/
+
+
+/*-----------------------------------------------------------------
+ *   IMPLEMENTATION NOTES
+ * The first bytes of the source are read by the constructor to
+ * recognize the format, and are given back by readInput before
+ * the rest of the source.
+ *
+ * A plain input is read by underflow in the thread of the
+ * reader. A compressed input is read and decompressed by the
+ * producer thread into BLOCKS blocks: the producer takes a free
+ * block, fills it and puts it in the queue ready; underflow takes
+ * the next ready one, and puts the block it has finished back
+ * among the free ones. At the end of the data the last block is
+ * kept in the get area, so that seekoff can still move back in
+ * it. The producer stops when the input ends or an error is
+ * found, and reports it through done and failure; the error is
+ * raised by underflow, in the thread of the reader, after the
+ * data decompressed before it.
+ *-----------------------------------------------------------------*/
+
+
+#include <stddef.h>
+#include <string.h>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+#include "zstream.h"
+#include "error.h"
+
+
+/*----------------------------------------------------------
+ * DecompressBuf::DecompressBuf(src)
+ * Constructor. Recognizes the format of src, and for a
+ * compressed input starts the producer thread.
+ ---------------------------------------------------------*/
+DecompressBuf::DecompressBuf(istream &src): src(src)
+  { int k;
+    src.read(magic, sizeof(magic));
+    magic_len=src.gcount();
+    magic_pos=0;
+    base=0;
+    current=-1;
+    done=stop=false;
+    failure=NULL;
+
+    const unsigned char *m=(const unsigned char*)magic;
+    if (magic_len>=2 && m[0]==0x1F && m[1]==0x8B)
+      format=GZIP_INPUT;
+    else if (magic_len>=4 && m[0]==0x28 && m[1]==0xB5 &&
+             m[2]==0x2F && m[3]==0xFD)
+      format=ZSTD_INPUT;
+    else
+      format=PLAIN_INPUT;
+
+#ifndef HAVE_ZLIB
+    if (format==GZIP_INPUT)
+      error("DecompressBuf: gzip input not supported "
+            "(compile with HAVE_ZLIB)");
+#endif
+#ifndef HAVE_ZSTD
+    if (format==ZSTD_INPUT)
+      error("DecompressBuf: zstd input not supported "
+            "(compile with HAVE_ZSTD)");
+#endif
+
+    if (format==PLAIN_INPUT)
+      { block[0].resize(BLOCK_SIZE);
+        return;
+      }
+    for(k=0; k<BLOCKS; k++)
+      { block[k].resize(BLOCK_SIZE);
+        free_blocks.push_back(k);
+      }
+    producer=std::thread(&DecompressBuf::produce, this);
+  }
+
+
+/*----------------------------------------------------------
+ * DecompressBuf::~DecompressBuf()
+ * Destructor. Stops the producer thread.
+ ---------------------------------------------------------*/
+DecompressBuf::~DecompressBuf()
+  { if (producer.joinable())
+      { { std::lock_guard<std::mutex> lock(mtx);
+          stop=true;
+        }
+        cond.notify_all();
+        producer.join();
+      }
+  }
+
+
+/*----------------------------------------------------------
+ * int_type DecompressBuf::underflow()
+ * Makes the next block of data available.
+ ---------------------------------------------------------*/
+DecompressBuf::int_type DecompressBuf::underflow()
+  { if (gptr()<egptr())
+      return traits_type::to_int_type(*gptr());
+
+    if (format==PLAIN_INPUT)
+      { char *p=&block[0][0];
+        size_t n=readInput(p, BLOCK_SIZE);
+        if (n==0)
+          return traits_type::eof();
+        base+=egptr()-eback();
+        setg(p, p, p+n);
+        return traits_type::to_int_type(*p);
+      }
+
+    std::unique_lock<std::mutex> lock(mtx);
+    while (ready.empty() && !done)
+      cond.wait(lock);
+    if (ready.empty())
+      { if (failure!=NULL)
+          error("DecompressBuf: %s", failure);
+        return traits_type::eof();
+      }
+    if (current>=0)
+      { free_blocks.push_back(current);
+        cond.notify_all();
+      }
+    current=ready.front();
+    ready.pop_front();
+    base+=egptr()-eback();
+    char *p=&block[current][0];
+    setg(p, p, p+block_len[current]);
+    return traits_type::to_int_type(*p);
+  }
+
+
+/*----------------------------------------------------------
+ * pos_type DecompressBuf::seekoff(off, dir, which)
+ * Moves the position within the current block, or returns
+ * the current position if off is 0.
+ ---------------------------------------------------------*/
+DecompressBuf::pos_type DecompressBuf::seekoff(off_type off,
+                                               ios_base::seekdir dir,
+                                               ios_base::openmode which)
+  { if (dir==ios_base::beg)
+      off-=base+(gptr()-eback());
+    else if (dir!=ios_base::cur)
+      return pos_type(off_type(-1));
+    if (!(which & ios_base::in) || off<eback()-gptr() ||
+        off>egptr()-gptr())
+      return pos_type(off_type(-1));
+    setg(eback(), gptr()+off, egptr());
+    return pos_type(base+(gptr()-eback()));
+  }
+
+DecompressBuf::pos_type DecompressBuf::seekpos(pos_type pos,
+                                               ios_base::openmode which)
+  { return seekoff(off_type(pos), ios_base::beg, which);
+  }
+
+
+/*----------------------------------------------------------
+ * size_t DecompressBuf::readInput(buf, len)
+ * Reads up to len bytes of the source, beginning with the
+ * ones read by the constructor. Returns 0 at the end.
+ ---------------------------------------------------------*/
+size_t DecompressBuf::readInput(char *buf, size_t len)
+  { size_t n=0;
+    while (magic_pos<magic_len && n<len)
+      buf[n++]=magic[magic_pos++];
+    if (n<len && src.good())
+      { src.read(buf+n, len-n);
+        n+=src.gcount();
+      }
+    return n;
+  }
+
+
+/*----------------------------------------------------------
+ * Producer side of the queues: takeFree waits for a free
+ * block (returning -1 if the stream is being destroyed),
+ * putReady passes a filled block to the reader, and finish
+ * signals the end of the data.
+ ---------------------------------------------------------*/
+int DecompressBuf::takeFree()
+  { std::unique_lock<std::mutex> lock(mtx);
+    while (free_blocks.empty() && !stop)
+      cond.wait(lock);
+    if (stop)
+      return -1;
+    int k=free_blocks.front();
+    free_blocks.pop_front();
+    return k;
+  }
+
+void DecompressBuf::putReady(int k, size_t len)
+  { { std::lock_guard<std::mutex> lock(mtx);
+      if (len>0)
+        { block_len[k]=len;
+          ready.push_back(k);
+        }
+      else
+        free_blocks.push_back(k);
+    }
+    cond.notify_all();
+  }
+
+void DecompressBuf::finish(const char *failure)
+  { { std::lock_guard<std::mutex> lock(mtx);
+      this->failure=failure;
+      done=true;
+    }
+    cond.notify_all();
+  }
+
+
+/*----------------------------------------------------------
+ * void DecompressBuf::produce()
+ * Body of the producer thread.
+ ---------------------------------------------------------*/
+void DecompressBuf::produce()
+  { const char *f=NULL;
+    if (format==GZIP_INPUT)
+      f=inflateGzip();
+    else if (format==ZSTD_INPUT)
+      f=decompressZstd();
+    finish(f);
+  }
+
+
+/*----------------------------------------------------------
+ * const char *DecompressBuf::inflateGzip()
+ * Decompresses a gzip input (possibly made of several
+ * members). Returns an error message, or NULL.
+ ---------------------------------------------------------*/
+const char *DecompressBuf::inflateGzip()
+  {
+#ifdef HAVE_ZLIB
+    std::vector<char> in(BLOCK_SIZE);
+    bool in_end=false;
+    const char *f=NULL;
+    z_stream z;
+    memset(&z, 0, sizeof(z));
+    if (inflateInit2(&z, 15+16)!=Z_OK)
+      return "cannot initialize zlib";
+
+    int k=takeFree();
+    if (k>=0)
+      { z.next_out=(Bytef*)&block[k][0];
+        z.avail_out=BLOCK_SIZE;
+      }
+    while (k>=0)
+      { if (z.avail_in==0 && !in_end)
+          { z.next_in=(Bytef*)&in[0];
+            z.avail_in=readInput(&in[0], in.size());
+            in_end= z.avail_in==0;
+          }
+        int r=inflate(&z, Z_NO_FLUSH);
+        if (r==Z_STREAM_END)
+          { // Another member may follow
+            if (z.avail_in==0 && !in_end)
+              { z.next_in=(Bytef*)&in[0];
+                z.avail_in=readInput(&in[0], in.size());
+                in_end= z.avail_in==0;
+              }
+            if (z.avail_in==0)
+              break;
+            inflateReset(&z);
+          }
+        else if (r==Z_BUF_ERROR)
+          { if (in_end)
+              { f="unexpected end of gzip data";
+                break;
+              }
+          }
+        else if (r!=Z_OK)
+          { f="corrupted gzip data";
+            break;
+          }
+        if (z.avail_out==0)
+          { putReady(k, BLOCK_SIZE);
+            k=takeFree();
+            if (k>=0)
+              { z.next_out=(Bytef*)&block[k][0];
+                z.avail_out=BLOCK_SIZE;
+              }
+          }
+      }
+    if (k>=0)
+      putReady(k, BLOCK_SIZE-z.avail_out);
+    inflateEnd(&z);
+    return f;
+#else
+    return "gzip input not supported";
+#endif
+  }
+
+
+/*----------------------------------------------------------
+ * const char *DecompressBuf::decompressZstd()
+ * Decompresses a zstd input (possibly made of several
+ * frames). Returns an error message, or NULL.
+ ---------------------------------------------------------*/
+const char *DecompressBuf::decompressZstd()
+  {
+#ifdef HAVE_ZSTD
+    std::vector<char> in(BLOCK_SIZE);
+    const char *f=NULL;
+    ZSTD_DStream *zs=ZSTD_createDStream();
+    if (zs==NULL || ZSTD_isError(ZSTD_initDStream(zs)))
+      { ZSTD_freeDStream(zs);
+        return "cannot initialize zstd";
+      }
+
+    ZSTD_inBuffer zin={ &in[0], 0, 0 };
+    ZSTD_outBuffer zout={ NULL, BLOCK_SIZE, 0 };
+    size_t r=0;
+    int k=takeFree();
+    if (k>=0)
+      zout.dst=&block[k][0];
+    while (k>=0)
+      { if (zin.pos==zin.size)
+          { zin.size=readInput(&in[0], in.size());
+            zin.pos=0;
+            if (zin.size==0)
+              { if (r!=0)
+                  f="unexpected end of zstd data";
+                break;
+              }
+          }
+        r=ZSTD_decompressStream(zs, &zout, &zin);
+        if (ZSTD_isError(r))
+          { f="corrupted zstd data";
+            break;
+          }
+        if (zout.pos==zout.size)
+          { putReady(k, BLOCK_SIZE);
+            k=takeFree();
+            if (k>=0)
+              { zout.dst=&block[k][0];
+                zout.pos=0;
+              }
+          }
+      }
+    if (k>=0)
+      putReady(k, zout.pos);
+    ZSTD_freeDStream(zs);
+    return f;
+#else
+    return "zstd input not supported";
+#endif
+  }